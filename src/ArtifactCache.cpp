@@ -0,0 +1,126 @@
+#include "ArtifactCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+static const char MAGIC[8] = {'T', 'S', 'P', 'A', 'R', 'T', 'F', '1'};
+static const std::size_t CHUNK = 1 << 20;      // bytes read from a dataset file at a time, a multiple of 8
+
+static uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t ArtifactCache::hashBytes(const char* data, std::size_t size, uint64_t seed) {
+    uint64_t h = mix(seed ^ (size * 0x9e3779b97f4a7c15ull));
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ mix(word)) * 0x9e3779b97f4a7c15ull;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    return mix(h ^ mix(tail));
+}
+
+/**
+ * Chains the hash of the file onto hash, a chunk at a time.
+ */
+static bool hashFile(const std::string& path, uint64_t& hash) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::vector<char> buffer(CHUNK);
+    do {
+        in.read(buffer.data(), buffer.size());
+        hash = ArtifactCache::hashBytes(buffer.data(), in.gcount(), hash);
+    } while (in);
+    return in.eof();
+}
+
+ArtifactCache::ArtifactCache(std::string directory): directory(std::move(directory)) {}
+
+bool ArtifactCache::hashDataset(const std::string& type, const std::string& path, uint64_t& hash) {
+    hash = hashBytes(type.data(), type.size());
+    if (type == "real") return hashFile(path + "/nodes.csv", hash) && hashFile(path + "/edges.csv", hash);
+    return hashFile(path, hash);
+}
+
+/**
+ * Returns the key of an entry, from the dataset hash, the artifact and the parameters.
+ */
+static uint64_t entryKey(uint64_t dataset, const std::string& artifact, const std::string& params) {
+    uint64_t key = ArtifactCache::hashBytes(artifact.data(), artifact.size(), dataset);
+    return ArtifactCache::hashBytes(params.data(), params.size(), key);
+}
+
+std::string ArtifactCache::pathFor(uint64_t dataset, const std::string& artifact, const std::string& params) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long) entryKey(dataset, artifact, params));
+    return (std::filesystem::path(directory) / (artifact + "-" + name + ".bin")).string();
+}
+
+bool ArtifactCache::load(uint64_t dataset, const std::string& artifact, const std::string& params, std::string& payload) const {
+    payload.clear();
+    std::ifstream in(pathFor(dataset, artifact, params), std::ios::binary);
+    if (!in.is_open()) return false;
+    std::string entry((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    BinaryReader reader(entry);
+
+    char magic[sizeof(MAGIC)];
+    uint64_t key, entryDataset, paramsSize, payloadSize, checksum;
+    for (char& c : magic) if (!reader.get(c)) return false;
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!reader.get(key) || !reader.get(entryDataset) || !reader.get(paramsSize)) return false;
+    if (key != entryKey(dataset, artifact, params) || entryDataset != dataset || paramsSize != params.size()) return false;
+    std::size_t at = sizeof(MAGIC) + 3 * sizeof(uint64_t);
+    if (entry.compare(at, params.size(), params) != 0) return false;
+    at += params.size();
+    if (entry.size() - at < sizeof(uint64_t)) return false;
+    std::memcpy(&payloadSize, entry.data() + at, sizeof(uint64_t));
+    at += sizeof(uint64_t);
+    if (entry.size() - at != payloadSize + sizeof(uint64_t)) return false;
+    std::memcpy(&checksum, entry.data() + at + payloadSize, sizeof(uint64_t));
+    if (checksum != hashBytes(entry.data() + at, payloadSize)) return false;
+    payload.assign(entry, at, payloadSize);
+    return true;
+}
+
+bool ArtifactCache::store(uint64_t dataset, const std::string& artifact, const std::string& params, const std::string& payload) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    std::string entry;
+    BinaryWriter writer(entry);
+    for (char c : MAGIC) writer.put(c);
+    writer.put(entryKey(dataset, artifact, params));
+    writer.put(dataset);
+    writer.put((uint64_t) params.size());
+    entry += params;
+    writer.put((uint64_t) payload.size());
+    entry += payload;
+    writer.put(hashBytes(payload.data(), payload.size()));
+
+    // written aside and renamed into place, so a concurrent load never reads half an entry
+    std::string path = pathFor(dataset, artifact, params);
+    std::string temporary = path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(entry.data(), entry.size());
+    out.close();
+    if (out.fail()) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+const std::string& ArtifactCache::getDirectory() const {
+    return directory;
+}
@@ -0,0 +1,105 @@
+#ifndef PROJETO_DA_2_ARTIFACTCACHE_H
+#define PROJETO_DA_2_ARTIFACTCACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+/**
+ * Appends trivially copyable values to a byte buffer, in the layout of the machine, for the payloads of ArtifactCache.
+ */
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::string& out): out(out) {}
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+        out.append((const char*) &value, sizeof(T));
+    }
+
+private:
+    std::string& out;
+};
+
+/**
+ * Reads back the values written by a BinaryWriter, failing instead of reading past the end of the buffer.
+ */
+class BinaryReader {
+public:
+    explicit BinaryReader(const std::string& in): in(in) {}
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+        if (in.size() - at < sizeof(T)) return false;
+        std::memcpy(&value, in.data() + at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+    /**
+     * Checks if every byte of the buffer was read.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool done() const { return at == in.size(); }
+
+private:
+    const std::string& in;
+    std::size_t at = 0;
+};
+
+/**
+ * On-disk store of the intermediate results of the solvers (parsed graphs, candidate sets, tours, bounds), addressed by
+ * the contents of the dataset they were computed from: an entry is keyed by a hash of the dataset files, the name of the
+ * artifact and a string with every parameter it depends on, so a dataset that changed on disk, or a run with other
+ * parameters, simply misses. Each entry is a file with a header (magic, key, dataset hash, parameters), the payload and
+ * a checksum of the payload, all checked on load, and is written aside and renamed into place so that concurrent runs
+ * never read half of one.
+ */
+class ArtifactCache {
+public:
+    /**
+     * Constructor of the ArtifactCache class. The directory is created by the first store.
+     * @param directory Represents the directory of the entries
+     * @note Time-complexity -> O(1)
+     */
+    explicit ArtifactCache(std::string directory);
+    /**
+     * Hashes the files of a dataset, 8 bytes at a time.
+     * @param type Represents the type of the dataset, as in loadDataset: for "real" both nodes.csv and edges.csv are hashed
+     * @param path Represents the dataset file, or for "real" its directory
+     * @param hash Represents the variable to which the hash is written
+     * @return True if every file could be read, false otherwise
+     * @note Time-complexity -> O(n) with n being the size of the files
+     */
+    static bool hashDataset(const std::string& type, const std::string& path, uint64_t& hash);
+    /**
+     * Hashes a buffer, 8 bytes at a time.
+     * @note Time-complexity -> O(n) with n being the size of the buffer
+     */
+    static uint64_t hashBytes(const char* data, std::size_t size, uint64_t seed = 0);
+    /**
+     * Returns the file of the entry of an artifact. Artifacts with a format of their own (e.g. a CandidateSet, which checks
+     * its file itself) can be kept there directly, still addressed by the dataset and the parameters.
+     * @note Time-complexity -> O(p) with p being the size of the parameters
+     */
+    [[nodiscard]] std::string pathFor(uint64_t dataset, const std::string& artifact, const std::string& params) const;
+    /**
+     * Reads the payload of an entry written by store.
+     * @param payload Represents the variable to which the payload is written
+     * @return True if the entry exists and its header and checksum are valid, false otherwise
+     * @note Time-complexity -> O(n) with n being the size of the entry
+     */
+    bool load(uint64_t dataset, const std::string& artifact, const std::string& params, std::string& payload) const;
+    /**
+     * Writes an entry, replacing the one with the same key.
+     * @return True if the entry was written, false otherwise
+     * @note Time-complexity -> O(n) with n being the size of the payload
+     */
+    bool store(uint64_t dataset, const std::string& artifact, const std::string& params, const std::string& payload) const;
+    [[nodiscard]] const std::string& getDirectory() const;
+
+private:
+    std::string directory;
+};
+
+#endif //PROJETO_DA_2_ARTIFACTCACHE_H
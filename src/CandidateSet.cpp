@@ -0,0 +1,283 @@
+#include "CandidateSet.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include "KdTree.h"
+#include "OneTreeBound.h"
+#include "Stats.h"
+
+static const unsigned int POOL_FACTOR = 5;     // nodes ranked per candidate kept, when not ranking every node
+static const char MAGIC[8] = {'T', 'S', 'P', 'C', 'A', 'N', 'D', '2'};
+
+static const char* kindName(CandidateKind kind) {
+    switch (kind) {
+        case CandidateKind::QUADRANT: return "quadrant";
+        case CandidateKind::ALPHA: return "alpha";
+        default: return "nearest";
+    }
+}
+
+CandidateSet::CandidateSet(Graph& graph, ThreadPool& pool): graph(graph), pool(pool), nodes(graph.getNodeSet()) {
+    for (unsigned int i = 0; i < nodes.size(); i++) local.emplace(nodes[i], i);
+}
+
+void CandidateSet::candidatePool(unsigned int i, unsigned int size, const KdTree* tree, vector<unsigned int>& found) const {
+    found.clear();
+    if (tree == nullptr) {
+        for (unsigned int j = 0; j < nodes.size(); j++) if (j != i) found.push_back(j);
+        return;
+    }
+    for (unsigned int j : tree->nearest(nodes[i]->getLon(), nodes[i]->getLat(), size + 1)) {
+        if (j != i) found.push_back(j);
+    }
+    for (Edge* edge : nodes[i]->getAdj()) {
+        auto it = local.find(edge->getDest());
+        if (it != local.end() && it->second != i) found.push_back(it->second);
+    }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+}
+
+template <typename Rank>
+void CandidateSet::buildRanked(unsigned int count, Rank rank) {
+    unsigned int n = nodes.size();
+    bool everyNode = n <= OneTreeBound::MAX_COMPLETE_NODES;
+    std::unique_ptr<KdTree> tree;
+    if (!everyNode) tree = std::make_unique<KdTree>(nodes, graph.getPrecision().getStorage());
+
+    vector<vector<unsigned int>> chosen(n);
+    unsigned int tasks = std::min(pool.size() + 1, std::max(1u, n));
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        vector<unsigned int> found;
+        vector<pair<pair<double, double>, unsigned int>> ranked;
+        for (unsigned int i = t; i < n; i += tasks) {
+            candidatePool(i, POOL_FACTOR * count, tree.get(), found);
+            ranked.clear();
+            for (unsigned int j : found) ranked.emplace_back(rank(i, j), j);
+            std::sort(ranked.begin(), ranked.end());
+            if (kind != CandidateKind::QUADRANT) {
+                for (unsigned int c = 0; c < ranked.size() && chosen[i].size() < count; c++) chosen[i].push_back(ranked[c].second);
+                continue;
+            }
+            // the closest of each quadrant first, then the closest of the rest, kept in order of distance
+            unsigned int perQuadrant = std::max(1u, count / 4), inQuadrant[4] = {0, 0, 0, 0};
+            vector<bool> taken(ranked.size(), false);
+            unsigned int kept = 0;
+            for (unsigned int c = 0; c < ranked.size() && kept < count; c++) {
+                const Node* other = nodes[ranked[c].second];
+                unsigned int q = (other->getLon() >= nodes[i]->getLon()) + 2 * (other->getLat() >= nodes[i]->getLat());
+                if (inQuadrant[q] < perQuadrant) inQuadrant[q]++, taken[c] = true, kept++;
+            }
+            for (unsigned int c = 0; c < ranked.size() && kept < count; c++) {
+                if (!taken[c]) taken[c] = true, kept++;
+            }
+            for (unsigned int c = 0; c < ranked.size(); c++) if (taken[c]) chosen[i].push_back(ranked[c].second);
+        }
+    });
+
+    offsets.assign(1, 0);
+    neighbours.clear();
+    for (auto& list : chosen) {
+        neighbours.insert(neighbours.end(), list.begin(), list.end());
+        offsets.push_back(neighbours.size());
+    }
+}
+
+bool CandidateSet::buildAlpha(unsigned int count) {
+    unsigned int n = nodes.size();
+    auto distance = [&](unsigned int i, unsigned int j) { return graph.getDistance(nodes[i], nodes[j]); };
+    if (n < 3) {    // every pair is in every tour
+        buildRanked(count, [&](unsigned int i, unsigned int j) { return std::make_pair(distance(i, j), 0.0); });
+        return true;
+    }
+    OneTreeBound bound(graph, pool);
+    if (!bound.run()) return false;
+    vector<pair<unsigned int, unsigned int>> oneTree = bound.getOneTree();
+    if (oneTree.size() < 2) return false;
+    const vector<double>& pi = bound.getPenalties();
+    auto modified = [&](unsigned int i, unsigned int j) { return distance(i, j) + pi[i] + pi[j]; };
+
+    // the first node takes part through its two edges (the last two of the 1-tree): forcing another edge of it in
+    // replaces the heavier one
+    double secondFirst = std::max(modified(0, oneTree[oneTree.size() - 2].second), modified(0, oneTree.back().second));
+
+    // the spanning tree of the other nodes, rooted at node 1, with binary lifting of the heaviest edge towards the root,
+    // so the heaviest edge of the path between two nodes (the one a forced edge would replace) takes O(log(n))
+    vector<vector<pair<unsigned int, double>>> tree(n);
+    for (unsigned int e = 0; e + 2 < oneTree.size(); e++) {
+        auto [u, v] = oneTree[e];
+        double w = modified(u, v);
+        tree[u].emplace_back(v, w);
+        tree[v].emplace_back(u, w);
+    }
+    unsigned int levels = 1;
+    while ((1u << levels) < n) levels++;
+    vector<vector<unsigned int>> up(levels, vector<unsigned int>(n, 1));
+    vector<vector<double>> heaviest(levels, vector<double>(n, -std::numeric_limits<double>::infinity()));
+    vector<unsigned int> depth(n, 0), stack = {1};
+    vector<bool> reached(n, false);
+    reached[1] = true;
+    while (!stack.empty()) {
+        unsigned int u = stack.back();
+        stack.pop_back();
+        for (auto [v, w] : tree[u]) {
+            if (reached[v]) continue;
+            reached[v] = true;
+            up[0][v] = u;
+            heaviest[0][v] = w;
+            depth[v] = depth[u] + 1;
+            stack.push_back(v);
+        }
+    }
+    for (unsigned int l = 1; l < levels; l++) {
+        for (unsigned int v = 1; v < n; v++) {
+            up[l][v] = up[l - 1][up[l - 1][v]];
+            heaviest[l][v] = std::max(heaviest[l - 1][v], heaviest[l - 1][up[l - 1][v]]);
+        }
+    }
+    auto pathHeaviest = [&](unsigned int a, unsigned int b) {
+        double result = -std::numeric_limits<double>::infinity();
+        if (depth[a] < depth[b]) std::swap(a, b);
+        for (unsigned int l = levels; l-- > 0;) {
+            if (depth[a] - depth[b] >= (1u << l)) result = std::max(result, heaviest[l][a]), a = up[l][a];
+        }
+        if (a == b) return result;
+        for (unsigned int l = levels; l-- > 0;) {
+            if (up[l][a] != up[l][b]) {
+                result = std::max({result, heaviest[l][a], heaviest[l][b]});
+                a = up[l][a];
+                b = up[l][b];
+            }
+        }
+        return std::max({result, heaviest[0][a], heaviest[0][b]});
+    };
+
+    // alpha first, distance to break the ties between the edges of the 1-tree (all at 0)
+    buildRanked(count, [&](unsigned int i, unsigned int j) {
+        double w = modified(i, j);
+        double alpha = i == 0 || j == 0 ? std::max(0.0, w - secondFirst) : w - pathHeaviest(i, j);
+        return std::make_pair(alpha, w);
+    });
+    return true;
+}
+
+bool CandidateSet::build(CandidateKind newKind, unsigned int newK) {
+    STATS_PHASE("candidates");
+    if (!graph.isEdgeIndexed()) graph.indexEdges();
+    kind = newKind;
+    k = newK;
+    offsets.clear();
+    neighbours.clear();
+    if (kind == CandidateKind::ALPHA) {
+        if (buildAlpha(k)) return true;
+        offsets.clear();
+        neighbours.clear();
+        return false;
+    }
+    buildRanked(k, [&](unsigned int i, unsigned int j) { return std::make_pair(graph.getDistance(nodes[i], nodes[j]), 0.0); });
+    return true;
+}
+
+bool CandidateSet::save(const std::string& path, uint64_t dataset) const {
+    // written aside and renamed into place, so a concurrent load never reads half a file
+    std::string temporary = path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    uint32_t header[4] = {(uint32_t) kind, k, (uint32_t) nodes.size(), (uint32_t) graph.getPrecision().getStorage()};
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write((const char*) header, sizeof(header));
+    out.write((const char*) &dataset, sizeof(dataset));
+    for (Node* node : nodes) {
+        int32_t id = node->getId();
+        out.write((const char*) &id, sizeof(id));
+    }
+    out.write((const char*) offsets.data(), offsets.size() * sizeof(unsigned int));
+    out.write((const char*) neighbours.data(), neighbours.size() * sizeof(unsigned int));
+    out.close();
+    std::error_code error;
+    if (out.fail()) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+bool CandidateSet::load(const std::string& path, uint64_t dataset, CandidateKind wantedKind, unsigned int wantedK) {
+    offsets.clear();
+    neighbours.clear();
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    unsigned int n = nodes.size();
+    char magic[sizeof(MAGIC)];
+    uint32_t header[4];
+    uint64_t builtFrom;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!in.read((char*) header, sizeof(header)) || !in.read((char*) &builtFrom, sizeof(builtFrom))) return false;
+    if (header[0] != (uint32_t) wantedKind || header[1] != wantedK || header[2] != n) return false;
+    if (header[3] != (uint32_t) graph.getPrecision().getStorage() || builtFrom != dataset) return false;
+    for (Node* node : nodes) {
+        int32_t id;
+        if (!in.read((char*) &id, sizeof(id)) || id != node->getId()) return false;
+    }
+
+    vector<unsigned int> readOffsets(n + 1);
+    if (!in.read((char*) readOffsets.data(), readOffsets.size() * sizeof(unsigned int))) return false;
+    if (readOffsets[0] != 0) return false;
+    for (unsigned int i = 0; i < n; i++) {
+        if (readOffsets[i + 1] < readOffsets[i] || readOffsets[i + 1] - readOffsets[i] > wantedK) return false;
+    }
+    vector<unsigned int> readNeighbours(readOffsets[n]);
+    if (!in.read((char*) readNeighbours.data(), readNeighbours.size() * sizeof(unsigned int))) return false;
+    for (unsigned int j : readNeighbours) if (j >= n) return false;
+    if (in.peek() != std::ifstream::traits_type::eof()) return false;
+
+    kind = wantedKind;
+    k = wantedK;
+    offsets = std::move(readOffsets);
+    neighbours = std::move(readNeighbours);
+    return true;
+}
+
+bool CandidateSet::loadOrBuild(const std::string& path, uint64_t dataset, CandidateKind wantedKind, unsigned int wantedK) {
+    loaded = load(path, dataset, wantedKind, wantedK);
+    if (loaded) return true;
+    if (!build(wantedKind, wantedK)) return false;
+    save(path, dataset);     // a read-only directory only costs the next run a rebuild
+    return true;
+}
+
+CandidateSet::Range CandidateSet::of(unsigned int i) const {
+    return {neighbours.data() + offsets[i], neighbours.data() + offsets[i + 1]};
+}
+
+const vector<Node*>& CandidateSet::getNodes() const {
+    return nodes;
+}
+
+bool CandidateSet::empty() const {
+    return offsets.empty();
+}
+
+bool CandidateSet::wasLoaded() const {
+    return loaded;
+}
+
+std::string CandidateSet::pathFor(const std::string& datasetPath, CandidateKind kind, Storage storage, unsigned int k) {
+    std::string name = std::string("candidates_") + kindName(kind) + "_" + std::to_string(k);
+    if (storage != Storage::DOUBLE) name += std::string("_") + Precision::name(storage);
+    name += ".bin";
+    if (std::filesystem::is_directory(datasetPath)) return (std::filesystem::path(datasetPath) / name).string();
+    return datasetPath + "." + name;
+}
+
+bool CandidateSet::parse(const std::string& name, CandidateKind& kind) {
+    if (name == "nearest") kind = CandidateKind::NEAREST;
+    else if (name == "quadrant") kind = CandidateKind::QUADRANT;
+    else if (name == "alpha") kind = CandidateKind::ALPHA;
+    else return false;
+    return true;
+}
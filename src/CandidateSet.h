@@ -0,0 +1,143 @@
+#ifndef PROJETO_DA_2_CANDIDATESET_H
+#define PROJETO_DA_2_CANDIDATESET_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+#include "ThreadPool.h"
+
+class KdTree;
+
+/**
+ * How the candidates of a node are chosen.
+ * NEAREST takes the closest nodes. QUADRANT takes the closest nodes of each of the four quadrants around the node (by
+ * longitude and latitude), then fills up with the closest ones, so that nodes at the edge of a cluster still get
+ * candidates towards the other clusters. ALPHA takes the nodes with the lowest alpha-nearness: how much the lightest
+ * 1-tree (with the penalties of the Held-Karp bound) grows when the edge to the node is forced into it, which points to
+ * the edges of the optimal tour far better than the distance does.
+ */
+enum class CandidateKind { NEAREST, QUADRANT, ALPHA };
+
+/**
+ * Short list of promising neighbours for each node of a graph, for local searches and construction heuristics. The lists
+ * are kept in one flat array indexed by an offset per node, and can be saved to a binary file next to the dataset so the
+ * next run loads them instead of building them again.
+ */
+class CandidateSet {
+public:
+    static const unsigned int DEFAULT_K = 8;
+
+    /**
+     * Positions, in getNodes, of the candidates of one node, best first.
+     */
+    struct Range {
+        const unsigned int* first;
+        const unsigned int* last;
+        [[nodiscard]] const unsigned int* begin() const { return first; }
+        [[nodiscard]] const unsigned int* end() const { return last; }
+        [[nodiscard]] unsigned int size() const { return last - first; }
+    };
+
+    /**
+     * Constructor of the CandidateSet class, with no candidates, over the nodes of the graph in the order of getNodeSet.
+     * @param graph Represents the graph whose nodes get the candidates
+     * @param pool Represents the pool the candidates are built on
+     * @note Time-complexity -> O(n) with n being the number of nodes
+     */
+    explicit CandidateSet(Graph& graph, ThreadPool& pool = ThreadPool::shared());
+    /**
+     * Builds the candidates of every node, in parallel. Every kind ranks a pool of nodes per node: its nearest nodes by
+     * coordinates (through a KdTree) plus the ends of its edges, or every node if the graph is small enough for
+     * OneTreeBound to take every pair. Builds the edge index of the graph if it is not up to date.
+     * @param kind Represents how the candidates are chosen
+     * @param k Represents the number of candidates per node (fewer if the graph has fewer nodes)
+     * @return True if the candidates were built, false if ALPHA found no 1-tree (the set is then left empty)
+     * @note Time-complexity -> O(n*(P*log(n) + D) / T) for NEAREST and QUADRANT, plus the cost of OneTreeBound::run for
+     * ALPHA, with P being the pool size, D the degree of the nodes and T the number of threads
+     */
+    bool build(CandidateKind kind, unsigned int k = DEFAULT_K);
+    /**
+     * Writes the candidates to a binary file: a header with the kind, k, the number of nodes, the storage mode of the
+     * graph and the hash of the dataset, then the ids of the nodes, the offsets and the candidates.
+     * @param dataset Represents the hash of the dataset files the graph was loaded from (ArtifactCache::hashDataset)
+     * @return True if the file was written, false otherwise
+     * @note Time-complexity -> O(n*k)
+     */
+    bool save(const std::string& path, uint64_t dataset) const;
+    /**
+     * Reads candidates written by save. The file is only accepted if it was built with the same kind and k over the same
+     * node ids in the same order, from the same dataset contents in the same storage mode (so edited weights are not
+     * ranked by stale lists), and its offsets and candidates are in range.
+     * @param dataset Represents the hash of the dataset files the graph was loaded from (ArtifactCache::hashDataset)
+     * @return True if the file was accepted, false otherwise (the set is then left empty)
+     * @note Time-complexity -> O(n*k)
+     */
+    bool load(const std::string& path, uint64_t dataset, CandidateKind kind, unsigned int k = DEFAULT_K);
+    /**
+     * Loads the candidates from the file given as parameter if load accepts it, otherwise builds them and saves them there.
+     * @param dataset Represents the hash of the dataset files the graph was loaded from (ArtifactCache::hashDataset)
+     * @return True if the set has candidates, false if building them failed
+     * @note Time-complexity -> The one of load, or of build plus save
+     */
+    bool loadOrBuild(const std::string& path, uint64_t dataset, CandidateKind kind, unsigned int k = DEFAULT_K);
+    /**
+     * Returns the candidates of the node at position i of getNodes.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] Range of(unsigned int i) const;
+    [[nodiscard]] const std::vector<Node*>& getNodes() const;
+    /**
+     * Checks if the candidates are built or loaded.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool empty() const;
+    /**
+     * Checks if the last call of loadOrBuild loaded the candidates from the file.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool wasLoaded() const;
+
+    /**
+     * Returns the file the candidates of a dataset are saved to: inside its directory for a real-world dataset, next to
+     * its file otherwise, named after the kind, k and, but for double, the storage mode.
+     * @note Time-complexity -> O(1)
+     */
+    static std::string pathFor(const std::string& datasetPath, CandidateKind kind, Storage storage = Storage::DOUBLE, unsigned int k = DEFAULT_K);
+    /**
+     * Parses the name of a kind: "nearest", "quadrant" or "alpha".
+     * @return True if the name is known, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    static bool parse(const std::string& name, CandidateKind& kind);
+
+private:
+    /**
+     * Writes into found the positions of the nodes worth ranking for node i, without i and without repeats: every node if
+     * tree is nullptr, otherwise its size nearest nodes by coordinates plus the ends of its edges.
+     */
+    void candidatePool(unsigned int i, unsigned int size, const KdTree* tree, std::vector<unsigned int>& found) const;
+    /**
+     * Builds the count candidates of every node from a (score, tie-break) per pair, lowest first (spread over the quadrants first for
+     * QUADRANT), ranking the pools of candidatePool.
+     */
+    template <typename Rank>
+    void buildRanked(unsigned int count, Rank rank);
+    /**
+     * Builds the ALPHA candidates, returning false if there is no 1-tree.
+     */
+    bool buildAlpha(unsigned int count);
+
+    Graph& graph;
+    ThreadPool& pool;
+    std::vector<Node*> nodes;
+    std::unordered_map<const Node*, unsigned int> local;    // position of each node in nodes
+    CandidateKind kind = CandidateKind::NEAREST;
+    unsigned int k = 0;
+    std::vector<unsigned int> offsets;      // candidates of node i: neighbours[offsets[i], offsets[i + 1])
+    std::vector<unsigned int> neighbours;
+    bool loaded = false;
+};
+
+#endif //PROJETO_DA_2_CANDIDATESET_H
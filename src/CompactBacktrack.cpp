@@ -0,0 +1,90 @@
+#include "CompactBacktrack.h"
+#include <algorithm>
+#include "Stats.h"
+
+bool CompactBacktrack::fits(const Graph& graph) {
+    const std::vector<Node*>& nodeSet = graph.getNodeSet();
+    if (nodeSet.size() < 2 || nodeSet.size() > MAX_NODES) return false;
+    for (unsigned int i = 0; i < nodeSet.size(); i++) {
+        if (nodeSet[i]->getId() != (int) i) return false;
+    }
+    return true;
+}
+
+CompactBacktrack::CompactBacktrack(const Graph& graph): nodes(graph.getNodeSet()) {
+    offsets.reserve(nodes.size() + 1);
+    offsets.push_back(0);
+    for (Node* node : nodes) {
+        for (Edge* edge : node->getAdj()) {
+            targets.push_back((uint8_t) edge->getDest()->getId());
+            weights.push_back(edge->getWeight());
+        }
+        offsets.push_back(targets.size());
+    }
+    lightest = std::vector<double>(nodes.size(), 0);
+    for (unsigned int i = 1; i < nodes.size(); i++) {
+        if (offsets[i] == offsets[i + 1]) continue;
+        lightest[i] = weights[offsets[i]];
+        remaining += lightest[i];
+        if (targets[offsets[i]] == 0) closers |= uint64_t(1) << i;
+    }
+    bounded = std::all_of(weights.begin(), weights.end(), [](double w) { return w >= 0; });
+}
+
+double CompactBacktrack::solve(std::vector<Node*>& path) const {
+    unsigned int n = nodes.size();
+    path = std::vector<Node*>(n, nullptr);
+    double min = INT_MAX;
+    if (closers == 0) {
+        path.push_back(nodes[0]);
+        return min;
+    }
+
+    struct Frame {
+        unsigned int node, edge;    // node at this depth, next of its edges to look at
+        double cost;                // cost of the path up to node
+        double remaining;           // sum of the lightest edge of each node not visited yet
+    };
+    std::vector<Frame> stack(n);
+    uint64_t visited = 1;
+    stack[0] = {0, offsets[0], 0, remaining};
+    STATS_COUNT(BB_EXPANSIONS, 1);
+    int depth = 0;
+    while (depth >= 0) {
+        Frame& frame = stack[depth];
+        if (frame.edge == offsets[frame.node + 1]) {
+            visited &= ~(uint64_t(1) << frame.node);
+            depth--;
+            continue;
+        }
+        unsigned int next = targets[frame.edge];
+        double cost = frame.cost + weights[frame.edge];
+        frame.edge++;
+        // the edges are sorted, so once an edge is too heavy so are the next ones; the bound is only used when it holds
+        // by more than the rounding of the sums, so the subtrees it cuts only have tours heavier than min
+        if (cost >= min || (bounded && cost + frame.remaining >= min * BOUND_MARGIN)) {
+            STATS_COUNT(BB_PRUNES, 1);
+            visited &= ~(uint64_t(1) << frame.node);
+            depth--;
+            continue;
+        }
+        if (visited >> next & 1) continue;
+
+        if (depth + 1 == (int) n - 1) {
+            // the last node only closes the cycle if its first edge goes back to node 0
+            if (!(closers >> next & 1) || cost + weights[offsets[next]] >= min) continue;
+            min = cost + weights[offsets[next]];
+            for (int d = 0; d <= depth; d++) path[d] = nodes[stack[d].node];
+            path[n - 1] = nodes[next];
+            continue;
+        }
+        // a path is only worth extending while one of the nodes that can close it is left for the end
+        if ((closers & ~(visited | uint64_t(1) << next)) == 0) continue;
+        visited |= uint64_t(1) << next;
+        STATS_COUNT(BB_EXPANSIONS, 1);
+        STATS_MAX(RECURSION_DEPTH, depth + 1);
+        stack[++depth] = {next, offsets[next], cost, frame.remaining - lightest[next]};
+    }
+    path.push_back(nodes[0]);
+    return min;
+}
@@ -0,0 +1,53 @@
+#ifndef PROJETO_DA_2_COMPACTBACKTRACK_H
+#define PROJETO_DA_2_COMPACTBACKTRACK_H
+
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * The search of Graph::tspBTRec over a compact copy of a small graph: the adjacency of every node packed into one array
+ * of (destination, weight) in the order of its adjacency vector, the visited nodes in a 64-bit mask and the recursion
+ * turned into an explicit stack. The tours are visited in the same order and their weights summed in the same order, so
+ * the optimal cost (and the path) is exactly the one of tspBTRec. On top of its pruning, a path is dropped once the
+ * nodes tspBTRec can close a cycle from are all visited, or once its cost plus the lightest edge of every node left
+ * reaches the best cost found; both only drop paths that cannot lead to a lighter tour.
+ */
+class CompactBacktrack {
+public:
+    static const unsigned int MAX_NODES = 64;
+    static constexpr double BOUND_MARGIN = 1 + 1e-9;   // far above the rounding of a sum of 64 weights
+
+    /**
+     * Checks if the graph can be solved by a CompactBacktrack: it has between 2 and MAX_NODES nodes and the id of every
+     * node is its position in the NodeSet, as tspBTRec expects.
+     * @note Time-complexity -> O(V) with V being the number of nodes
+     */
+    static bool fits(const Graph& graph);
+    /**
+     * Constructor of the CompactBacktrack class. Copies the adjacency of the nodes of the graph, which must fit.
+     * @param graph Represents the graph to be solved
+     * @note Time-complexity -> O(V+E) with V being the number of nodes and E the number of edges
+     */
+    explicit CompactBacktrack(const Graph& graph);
+    /**
+     * Finds the optimal hamiltonian cycle from node 0, as Graph::tspBT.
+     * @param path Represents the path taken: the nodes of the cycle closed by node 0, or, if there is none, a nullptr at
+     * each position followed by node 0
+     * @return The weight of the optimal path, INT_MAX if there is none
+     * @note Time-complexity -> O((n-1)!*E) with n being the number of nodes in the graph
+     */
+    double solve(std::vector<Node*>& path) const;
+
+private:
+    std::vector<Node*> nodes;
+    std::vector<unsigned int> offsets;  // edges of node i: [offsets[i], offsets[i + 1])
+    std::vector<uint8_t> targets;
+    std::vector<double> weights;
+    std::vector<double> lightest;       // weight of the first edge of each node, 0 for node 0
+    double remaining = 0;               // sum of lightest: no path from node 0 can be closed for less
+    uint64_t closers = 0;               // mask of the nodes whose first edge goes to node 0, the only ones tspBTRec closes from
+    bool bounded = false;               // if no weight is negative, so remaining is a lower bound of the rest of a tour
+};
+
+#endif //PROJETO_DA_2_COMPACTBACKTRACK_H
@@ -0,0 +1,129 @@
+#include "DatasetCatalog.h"
+#include <algorithm>
+#include <filesystem>
+#include "parse.h"
+
+namespace fs = std::filesystem;
+
+DatasetCatalog::DatasetCatalog(const std::string& root, std::size_t budget): budget(budget) {
+    std::error_code error;
+    std::vector<Dataset> toy, extra, real;
+    for (const auto& file : fs::directory_iterator(fs::path(root) / "Toy-Graphs", error)) {
+        if (file.path().extension() == ".csv") toy.push_back({"toy", file.path().stem().string(), file.path().string()});
+    }
+    for (const auto& file : fs::directory_iterator(fs::path(root) / "Extra_Fully_Connected_Graphs", error)) {
+        std::string stem = file.path().stem().string();
+        if (file.path().extension() == ".csv" && stem.rfind("edges_", 0) == 0 && stem.size() > 6
+            && std::all_of(stem.begin() + 6, stem.end(), ::isdigit)) {
+            extra.push_back({"extra", stem.substr(6), file.path().string()});
+        }
+    }
+    for (const auto& directory : fs::directory_iterator(fs::path(root) / "Real-World-Graphs", error)) {
+        if (fs::exists(directory.path() / "nodes.csv") && fs::exists(directory.path() / "edges.csv")) {
+            real.push_back({"real", directory.path().filename().string(), directory.path().string()});
+        }
+    }
+    auto byName = [](const Dataset& a, const Dataset& b) { return a.name < b.name; };
+    std::sort(toy.begin(), toy.end(), byName);
+    std::sort(extra.begin(), extra.end(), [](const Dataset& a, const Dataset& b) { return std::stoul(a.name) < std::stoul(b.name); });
+    std::sort(real.begin(), real.end(), byName);
+    for (auto* group : {&toy, &extra, &real}) datasets.insert(datasets.end(), group->begin(), group->end());
+    slots = std::vector<Slot>(datasets.size());
+}
+
+DatasetCatalog::~DatasetCatalog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending.clear();
+    }
+    if (preloader.joinable()) preloader.join();
+}
+
+const std::vector<Dataset>& DatasetCatalog::getDatasets() const {
+    return datasets;
+}
+
+std::vector<Dataset> DatasetCatalog::getDatasets(const std::string& type) const {
+    std::vector<Dataset> found;
+    for (const Dataset& dataset : datasets) if (dataset.type == type) found.push_back(dataset);
+    return found;
+}
+
+int DatasetCatalog::find(const std::string& type, const std::string& name) const {
+    for (unsigned int i = 0; i < datasets.size(); i++) {
+        if (datasets[i].type == type && datasets[i].name == name) return (int) i;
+    }
+    return -1;
+}
+
+void DatasetCatalog::preload(const std::vector<unsigned int>& positions) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (unsigned int position : positions) if (position < slots.size()) pending.push_back(position);
+    if (preloading || pending.empty()) return;
+    if (preloader.joinable()) preloader.join();     // done with the previous batch, as preloading is false
+    preloading = true;
+    preloader = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping && !pending.empty()) {
+            unsigned int position = pending.front();
+            pending.pop_front();
+            if (slots[position].state != State::UNLOADED) continue;
+            if (!load(position, lock, false) && slots[position].state == State::UNLOADED) pending.clear();   // the budget is full
+        }
+        preloading = false;
+    });
+}
+
+bool DatasetCatalog::load(unsigned int position, std::unique_lock<std::mutex>& lock, bool evict) {
+    Slot& slot = slots[position];
+    slot.state = State::LOADING;
+    lock.unlock();
+    auto graph = std::make_shared<Graph>();
+    bool ok = loadDataset(graph.get(), datasets[position].type, datasets[position].path);
+    if (ok) graph->indexEdges();
+    std::size_t bytes = ok ? graph->memoryBytes() : 0;
+    lock.lock();
+
+    bool kept = ok && (evict || used + bytes <= budget);
+    if (kept) {
+        // the least recently used ones go first; a dataset larger than the whole budget is still kept, alone
+        while (used + bytes > budget) {
+            Slot* oldest = nullptr;
+            for (Slot& other : slots) {
+                if (&other != &slot && other.state == State::LOADED && (oldest == nullptr || other.lastUsed < oldest->lastUsed)) oldest = &other;
+            }
+            if (oldest == nullptr) break;
+            oldest->graph.reset();
+            oldest->state = State::UNLOADED;
+            used -= oldest->bytes;
+        }
+        slot.graph = std::move(graph);
+        slot.bytes = bytes;
+        slot.lastUsed = ++clock;
+        used += bytes;
+    }
+    slot.state = kept ? State::LOADED : ok ? State::UNLOADED : State::FAILED;
+    loaded.notify_all();
+    return kept;
+}
+
+std::shared_ptr<Graph> DatasetCatalog::acquire(unsigned int position) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (position >= slots.size()) return nullptr;
+    loaded.wait(lock, [&]() { return slots[position].state != State::LOADING; });
+    Slot& slot = slots[position];
+    if (slot.state != State::LOADED && !load(position, lock, true)) return nullptr;
+    slot.lastUsed = ++clock;
+    return slot.graph;
+}
+
+bool DatasetCatalog::isLoaded(unsigned int position) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return position < slots.size() && slots[position].state == State::LOADED;
+}
+
+std::size_t DatasetCatalog::memoryBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+}
@@ -0,0 +1,120 @@
+#ifndef PROJETO_DA_2_DATASETCATALOG_H
+#define PROJETO_DA_2_DATASETCATALOG_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * A dataset found by a DatasetCatalog.
+ */
+struct Dataset {
+    std::string type;   // toy, extra or real, as in loadDataset
+    std::string name;   // the file name without extension for toy, the number of nodes for extra, the directory for real
+    std::string path;   // the file, or for real the directory with nodes.csv and edges.csv
+};
+
+/**
+ * The datasets of a data directory, loaded on demand and kept loaded for the next time they are asked for. Some of them
+ * can be preloaded by a background thread, so that picking them later is instant. The loaded graphs are kept under a
+ * memory budget: when a dataset asked for does not fit, the ones used least recently are dropped (a graph still held by
+ * its user lives on until it lets it go).
+ */
+class DatasetCatalog {
+public:
+    static const std::size_t DEFAULT_BUDGET = std::size_t(1) << 30;
+
+    /**
+     * Constructor of the DatasetCatalog class. Finds the datasets under root: the csv files of Toy-Graphs, the edges_<n>.csv
+     * files of Extra_Fully_Connected_Graphs and the directories of Real-World-Graphs with a nodes.csv and an edges.csv,
+     * each group sorted (the extra ones by number of nodes).
+     * @param root Represents the data directory
+     * @param budget Represents the bytes the loaded graphs may take, as estimated by Graph::memoryBytes
+     * @note Time-complexity -> O(F*log(F)) with F being the number of files under root
+     */
+    explicit DatasetCatalog(const std::string& root, std::size_t budget = DEFAULT_BUDGET);
+    /**
+     * Destructor of the DatasetCatalog class. Stops the preloading, once the dataset being loaded is done.
+     */
+    ~DatasetCatalog();
+    DatasetCatalog(const DatasetCatalog&) = delete;
+    DatasetCatalog& operator=(const DatasetCatalog&) = delete;
+
+    /**
+     * Returns the datasets found, in the order of the constructor.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<Dataset>& getDatasets() const;
+    /**
+     * Returns the datasets of one type, in the order of the constructor.
+     * @note Time-complexity -> O(D) with D being the number of datasets
+     */
+    [[nodiscard]] std::vector<Dataset> getDatasets(const std::string& type) const;
+    /**
+     * Returns the position in getDatasets of the dataset with the given type and name, -1 if there is none.
+     * @note Time-complexity -> O(D) with D being the number of datasets
+     */
+    [[nodiscard]] int find(const std::string& type, const std::string& name) const;
+    /**
+     * Loads the datasets at the given positions one after the other on a background thread, with their edges indexed,
+     * after the ones still queued by earlier calls, until the budget is full: a dataset that does not fit is dropped and
+     * ends the preloading, without evicting others.
+     * @note Time-complexity -> O(1), the loading runs in the background
+     */
+    void preload(const std::vector<unsigned int>& positions);
+    /**
+     * Returns the graph of the dataset at the given position, loading it (with its edges indexed) if it is not loaded
+     * yet, or waiting for it if it is being loaded, and marks it as the most recently used. The graph is shared with the
+     * next calls, so it must be left as it was found, apart from the marks the solvers reset themselves.
+     * @return The graph, or nullptr if the position is out of range or the dataset could not be loaded
+     * @note Time-complexity -> O(1) if loaded, the one of loadDataset otherwise
+     */
+    std::shared_ptr<Graph> acquire(unsigned int position);
+    /**
+     * Checks if the dataset at the given position is loaded.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool isLoaded(unsigned int position);
+    /**
+     * Returns the bytes taken by the loaded graphs, as estimated by Graph::memoryBytes.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t memoryBytes();
+
+private:
+    enum class State { UNLOADED, LOADING, LOADED, FAILED };
+    struct Slot {
+        State state = State::UNLOADED;
+        std::shared_ptr<Graph> graph;
+        std::size_t bytes = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    /**
+     * Loads the dataset at the given position outside of the lock and stores it, evicting the least recently used
+     * datasets if it does not fit, or dropping it instead if evict is false. Called with the lock held, which it
+     * releases while loading.
+     * @return True if the dataset was kept, false otherwise
+     */
+    bool load(unsigned int position, std::unique_lock<std::mutex>& lock, bool evict);
+
+    std::vector<Dataset> datasets;
+    std::vector<Slot> slots;
+    std::size_t budget;
+    std::size_t used = 0;
+    uint64_t clock = 0;
+    std::mutex mutex;
+    std::condition_variable loaded;
+    std::deque<unsigned int> pending;   // positions still to be preloaded
+    std::thread preloader;
+    bool preloading = false;
+    bool stopping = false;
+};
+
+#endif //PROJETO_DA_2_DATASETCATALOG_H
@@ -0,0 +1,98 @@
+#include "EdgeIndex.h"
+#include "NodeEdge.h"
+
+static const std::size_t MIN_CAPACITY = 16;
+
+static uint64_t edgeKey(int orig, int dest) {
+    return ((uint64_t) (uint32_t) orig << 32) | (uint32_t) dest;
+}
+
+static std::size_t hashKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+EdgeIndex::EdgeIndex(Precision precision): weights(precision) {}
+
+void EdgeIndex::reset(Precision newPrecision) {
+    keys = {};
+    weights.reset(newPrecision);
+    count = used = 0;
+}
+
+void EdgeIndex::clear() {
+    reset(weights.getPrecision());
+}
+
+std::size_t EdgeIndex::size() const {
+    return count;
+}
+
+std::size_t EdgeIndex::memoryBytes() const {
+    return keys.capacity() * sizeof(uint64_t) + weights.memoryBytes();
+}
+
+std::size_t EdgeIndex::slot(uint64_t key) const {
+    std::size_t mask = keys.size() - 1, s = hashKey(key) & mask, firstErased = keys.size();
+    while (keys[s] != EMPTY) {
+        if (keys[s] == key) return s;
+        if (keys[s] == ERASED && firstErased == keys.size()) firstErased = s;
+        s = (s + 1) & mask;
+    }
+    return firstErased != keys.size() ? firstErased : s;
+}
+
+void EdgeIndex::grow() {
+    std::vector<uint64_t> oldKeys = std::move(keys);
+    std::vector<double> oldWeights(oldKeys.size());
+    for (std::size_t s = 0; s < oldKeys.size(); s++) {
+        if (oldKeys[s] != EMPTY && oldKeys[s] != ERASED) oldWeights[s] = weights.get(s);
+    }
+
+    std::size_t capacity = std::max(MIN_CAPACITY, 2 * oldKeys.size());
+    while (count * 2 >= capacity) capacity *= 2;
+    keys.assign(capacity, EMPTY);
+    weights.assign(capacity);
+    used = count;
+    for (std::size_t s = 0; s < oldKeys.size(); s++) {
+        if (oldKeys[s] == EMPTY || oldKeys[s] == ERASED) continue;
+        std::size_t target = slot(oldKeys[s]);
+        keys[target] = oldKeys[s];
+        weights.set(target, oldWeights[s]);
+    }
+}
+
+void EdgeIndex::insert(int orig, int dest, double w) {
+    if ((used + 1) * 2 > keys.size()) grow();
+    uint64_t key = edgeKey(orig, dest);
+    std::size_t s = slot(key);
+    if (keys[s] == key) {
+        if (w < weights.get(s)) weights.set(s, w);
+        return;
+    }
+    if (keys[s] == EMPTY) used++;
+    keys[s] = key;
+    weights.set(s, w);
+    count++;
+}
+
+void EdgeIndex::erase(int orig, int dest) {
+    if (keys.empty()) return;
+    uint64_t key = edgeKey(orig, dest);
+    std::size_t s = slot(key);
+    if (keys[s] != key) return;
+    keys[s] = ERASED;
+    count--;
+}
+
+double EdgeIndex::find(int orig, int dest) const {
+    if (keys.empty()) return INF;
+    uint64_t key = edgeKey(orig, dest);
+    std::size_t mask = keys.size() - 1;
+    for (std::size_t s = hashKey(key) & mask; keys[s] != EMPTY; s = (s + 1) & mask) {
+        if (keys[s] == key) return weights.get(s);
+    }
+    return INF;
+}
@@ -0,0 +1,76 @@
+#ifndef PROJETO_DA_2_EDGEINDEX_H
+#define PROJETO_DA_2_EDGEINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "Precision.h"
+
+/**
+ * Weights of directed edges keyed by the ids of their endpoints, in a flat open-addressing table with linear probing.
+ * The weights are kept in a WeightArray, as doubles, floats or 32-bit fixed-point integers depending on the storage mode,
+ * so a compact mode takes 12 bytes per slot instead of 16. The table is kept at most half full.
+ */
+class EdgeIndex {
+public:
+    /**
+     * Constructor of the EdgeIndex class, with an empty table.
+     * @param precision Represents the storage mode of the weights
+     * @note Time-complexity -> O(1)
+     */
+    explicit EdgeIndex(Precision precision = Precision());
+    /**
+     * Removes every edge and changes the storage mode of the weights.
+     * @note Time-complexity -> O(1), the memory is given back
+     */
+    void reset(Precision newPrecision);
+    /**
+     * Removes every edge, keeping the storage mode.
+     * @note Time-complexity -> O(1), the memory is given back
+     */
+    void clear();
+    /**
+     * Adds the edge from orig to dest with weight w, keeping the lighter weight if it is already there.
+     * @note Time-complexity -> O(1) on average
+     */
+    void insert(int orig, int dest, double w);
+    /**
+     * Removes the edge from orig to dest, if it is there.
+     * @note Time-complexity -> O(1) on average
+     */
+    void erase(int orig, int dest);
+    /**
+     * Returns the weight of the edge from orig to dest.
+     * @return The weight of the edge if it is there, INF otherwise
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] double find(int orig, int dest) const;
+    /**
+     * Returns the number of edges in the table.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t size() const;
+    /**
+     * Returns the number of bytes taken by the table.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t memoryBytes() const;
+
+private:
+    /**
+     * Returns the slot holding key, or the first free slot of its probe sequence if it is not there.
+     */
+    [[nodiscard]] std::size_t slot(uint64_t key) const;
+    /**
+     * Doubles the capacity of the table and inserts every edge again, dropping the erased slots.
+     */
+    void grow();
+
+    static constexpr uint64_t EMPTY = ~0ull;
+    static constexpr uint64_t ERASED = ~0ull - 1;   // keys of ids -1, never used by a node
+
+    std::vector<uint64_t> keys;
+    WeightArray weights;                    // weight of the edge in each slot
+    std::size_t count = 0, used = 0;        // edges, and edges plus erased slots
+};
+
+#endif //PROJETO_DA_2_EDGEINDEX_H
@@ -1,589 +1,963 @@
-// By: Gonçalo Leão
-
-#include "Graph.h"
-#include "UFDS.h"
-#include "calculations.h"
-#include "parse.h"
-
-using namespace std;
-
-void Graph::calculateMissingToyDistances(){
-    vector<Node*> unconnectedNodes = this->getNodeSet();
-    int isEverythingConnected = 0;
-    int i = 0;
-    while(isEverythingConnected != unconnectedNodes.size()){
-        Node* curNode = unconnectedNodes[i];
-
-        if(curNode->getAdj().size()==this->getNumNode()-1 && !curNode->isVisited()){
-            isEverythingConnected++;
-            if(isEverythingConnected == unconnectedNodes.size()) return;
-            curNode->setVisited(true);
-            continue;
-        }
-
-        for(auto adj : unconnectedNodes[i]->getAdj()){
-            Node* nextNode = adj->getDest();
-
-            for(auto nextAdj : nextNode->getAdj()){
-                Node* finalNode = nextAdj->getDest();
-
-                if(curNode == finalNode) continue;
-
-                if(!isAlreadyInEdges(finalNode->getId(), unconnectedNodes[i]->getAdj())){
-                    double weight = adj->getWeight() + nextAdj->getWeight();
-                    this->addBidirectionalEdge(curNode->getId(),finalNode->getId(), weight);
-                }
-            }
-        }
-
-        if(i==unconnectedNodes.size()-1) i = 0;
-        else i++;
-
-    }
-}
-
-void Graph::cleanGraph(){
-    for(Node* node : NodeSet){
-        node->deleteAdj();
-        delete node;
-    }
-    NodeSet.clear();
-}
-
-int Graph::getNumNode() const {
-    return NodeSet.size();
-}
-
-std::vector<Node *> Graph::getNodeSet() const {
-    return NodeSet;
-}
-
-
-Node * Graph::findNode(const int &id) const {
-    for (auto v : NodeSet)
-        if (v->getId() == id)
-            return v;
-    return nullptr;
-}
-
-
-
-bool Graph::addNode(const int &id, double longitude, double latitude) {
-    if (findNode(id) != nullptr)
-        return false;
-    NodeSet.push_back(new Node(id, longitude, latitude));
-    return true;
-}
-
-void Graph::sortNodes(){
-    std::sort(NodeSet.begin(),NodeSet.end(),[](Node* a, Node* b){
-        return a->getId() < b->getId();
-    });
-}
-
-void Graph::sortEdges(){
-    for(Node* node : NodeSet){
-        node->sortEdges();
-    }
-}
-
-
-bool Graph::addEdge(const int &sourc, const int &dest, double w) {
-    auto v1 = findNode(sourc);
-    auto v2 = findNode(dest);
-    if (v1 == nullptr || v2 == nullptr)
-        return false;
-    v1->addEdge(v2, w);
-    return true;
-}
-
-bool Graph::addBidirectionalEdge(const int &sourc, const int &dest, double w) {
-    auto v1 = findNode(sourc);
-    auto v2 = findNode(dest);
-    if (v1 == nullptr || v2 == nullptr)
-        return false;
-    auto e1 = v1->addEdge(v2, w);
-    auto e2 = v2->addEdge(v1, w);
-    e1->setReverse(e2);
-    e2->setReverse(e1);
-    return true;
-}
-
-bool Graph::zeroHasNoEdgesLeft(){
-    for(Edge* edge : NodeSet[0]->getAdj()){
-        if(!edge->getDest()->isVisited()) return false;
-    }
-    return true;
-}
-
-double Graph::tspBTRec(std::vector<Node *>& path, double min, double curCost, unsigned int i, unsigned int curPathSize, bool ended){
-    if(zeroHasNoEdgesLeft()) return min;
-    if(!NodeSet[i]->isVisited()){
-        if(curPathSize == NodeSet.size()-1){
-            double distToZero;
-            for(Edge* e : NodeSet[i]->getAdj()){
-                if(e->getDest()->getId()==0){
-                    distToZero=e->getWeight();
-                    break;
-                }
-            }
-            double sum = tspBTRec(path,min,curCost+distToZero,0,curPathSize,true);
-            if(sum < min && NodeSet[i]->getAdj()[0]->getDest()->getId()==0){
-                min = sum;
-                path[curPathSize] = NodeSet[i];
-            }
-            return min;
-        }
-        NodeSet[i]->setVisited(true);
-    }
-    else if(ended){
-        min = (curCost < min) ? curCost : min;
-        return min;
-    }
-    else return min;
-
-    for(Edge* edge: NodeSet[i]->getAdj()){
-        Node* node = edge->getDest();
-        if(curCost+edge->getWeight() >= min) break;
-        double sum = tspBTRec(path,min,curCost+edge->getWeight(),node->getId(),curPathSize+1,false);
-        if (sum < min){
-            min = sum;
-            path[curPathSize] = NodeSet[i];
-        }
-    }
-
-    NodeSet[i]->setVisited(false);
-    return min;
-}
-
-double Graph::tspBT(std::vector<Node *>& path){
-    path = std::vector<Node *>(NodeSet.size(), 0);
-    for(int i = 0; i < NodeSet.size()-1; i++){
-        NodeSet[i]->setVisited(false);
-    }
-    double mean = tspBTRec(path,INT_MAX,0,0,0,false);
-    path.push_back(NodeSet[0]);
-    return mean;
-}
-
-void Graph::preOrder(Node* node,std::vector<Node*>& mst, bool firstIt, double& weight, const string& ex){
-    if(node== nullptr)return;
-    if(firstIt) mst.push_back(node);
-
-    for (Edge* edge : node->getAdj()) {
-        Node* nextNode = edge->getDest();
-
-        if(nextNode->getPath() != nullptr){
-            if(nextNode->getPath()->getOrig()->getId() == node->getId()){
-                Node* last = mst.back();
-                mst.push_back(nextNode);
-                double dist = getEdgeWeight(last, nextNode);
-                if(dist==INF && ex == "2"){
-                    weight += haversineDistance(last->getLon(), last->getLat(), nextNode->getLon(), nextNode->getLat());
-                } else{
-                    weight += dist;
-                }
-                preOrder(nextNode, mst, false, weight, ex);
-            }
-        }
-
-    }
-}
-
-double Graph::TriangularApproximationHeuristic(vector<Node*> nodeSet,std::vector<Node*>& L, const string& type, const string& ex){
-    if(nodeSet.size()==1&&type=="real"){
-        L.push_back(nodeSet[0]);
-        return 0;
-    } else if(nodeSet.size()==2 && type=="real"){
-        L.push_back(nodeSet[0]);
-        L.push_back(nodeSet[1]);
-        L.push_back(nodeSet[0]);
-        return 2*haversineDistance(nodeSet[0]->getLon(),nodeSet[0]->getLat(),nodeSet[1]->getLon(),nodeSet[1]->getLat());
-    } else if(nodeSet.size()==3 && type=="real"){
-        L.push_back(nodeSet[0]);
-        L.push_back(nodeSet[1]);
-        L.push_back(nodeSet[2]);
-        L.push_back(nodeSet[0]);
-        return haversineDistance(nodeSet[0]->getLon(),nodeSet[0]->getLat(),nodeSet[1]->getLon(),nodeSet[1]->getLat()) + haversineDistance(nodeSet[0]->getLon(),nodeSet[0]->getLat(),nodeSet[2]->getLon(),nodeSet[2]->getLat()) + haversineDistance(nodeSet[2]->getLon(),nodeSet[2]->getLat(),nodeSet[1]->getLon(),nodeSet[1]->getLat()) + haversineDistance(nodeSet[0]->getLon(),nodeSet[0]->getLat(),nodeSet[2]->getLon(),nodeSet[2]->getLat());
-    }
-
-    for(Node* node : NodeSet){
-        node->setPath(nullptr);
-        node->setVisited(false);
-    }
-
-    double weight = 0;
-
-    if (ex=="2") kruskal();
-    else{
-        kruskalEx3(nodeSet);
-    }
-
-    if(type == "toy" && ex=="2"){
-        for(Node* node : NodeSet){
-            node->setVisited(false);
-        }
-        calculateMissingToyDistances();
-    }
-
-    if(ex=="2")preOrder(NodeSet[0],L,true, weight, ex);
-    else if(ex=="3"){
-        preOrder(nodeSet[0],L,true, weight, ex);
-    }
-
-    Node* last = L.back();
-    Node* zero = L.front();
-    if(type!="real"){
-        for(auto e : last->getAdj()){
-            if(e->getDest()==zero){
-                weight+=e->getWeight();
-            }
-        }
-    }
-    else weight+=haversineDistance(last->getLon(),last->getLat(),zero->getLon(),zero->getLat());
-    if(ex != "3") L.push_back(zero);
-
-    return weight;
-}
-
-void Graph::dfsKruskalPath(Node *v) {
-    v->setVisited(true);
-    for (auto e : v->getAdj()) {
-        if (e->isSelected() && !e->getDest()->isVisited()) {
-            e->getDest()->setPath(e);
-            dfsKruskalPath(e->getDest());
-        }
-    }
-}
-
-double Graph::kruskal() {
-    UFDS ufds(NodeSet.size());
-    std::vector<Edge*> sortedEdges;
-
-    for (auto v: NodeSet) {
-        for (auto e: v->getAdj()) {
-            e->setSelected(false);
-            if (e->getOrig()->getId() < e->getDest()->getId()) {
-                sortedEdges.push_back(e);
-            }
-        }
-    }
-
-    std::sort(sortedEdges.begin(), sortedEdges.end(), [](const Edge* e1, const Edge* e2) {
-        return e1->getWeight() < e2->getWeight();
-    });
-
-    unsigned selectedEdges = 0;
-    double totalWeight = 0.0;
-    for (Edge* e: sortedEdges) {
-        Node* orig = e->getOrig();
-        Node* dest = e->getDest();
-
-        if (!ufds.isSameSet(orig->getId(), dest->getId())) {
-
-            ufds.linkSets(orig->getId(), dest->getId());
-
-            e->setSelected(true);
-            e->getReverse()->setSelected(true);
-            totalWeight += e->getWeight();
-
-            if (++selectedEdges == NodeSet.size() - 1) {
-                break;
-            }
-        }
-    }
-
-    for (auto v: NodeSet) {
-        v->setVisited(false);
-    }
-    NodeSet[0]->setPath(nullptr);
-
-    dfsKruskalPath(NodeSet[0]);
-
-    return totalWeight;
-}
-
-double Graph::kruskalEx3(vector<Node*>& nodeSet){
-    UFDS ufds(NodeSet.size());
-    std::vector<Edge*> sortedEdges;
-
-    for (auto v: nodeSet) {
-        for (auto e: v->getAdj()) {
-            e->setSelected(false);
-            if (e->getOrig()->getId() < e->getDest()->getId() && e->getDest()->isInsideVector(nodeSet)) {
-                sortedEdges.push_back(e);
-            }
-        }
-    }
-
-    std::sort(sortedEdges.begin(), sortedEdges.end(), [](const Edge* e1, const Edge* e2) {
-        return e1->getWeight() < e2->getWeight();
-    });
-
-    unsigned selectedEdges = 0;
-    double totalWeight = 0.0;
-    for (Edge* e: sortedEdges) {
-        Node* orig = e->getOrig();
-        Node* dest = e->getDest();
-
-        int origId = orig->getId();
-        int destId = dest->getId();
-
-        if (!ufds.isSameSet(origId, destId)) {
-
-            ufds.linkSets(orig->getId(), dest->getId());
-
-            e->setSelected(true);
-            e->getReverse()->setSelected(true);
-            totalWeight += e->getWeight();
-
-            if (++selectedEdges == nodeSet.size() - 1) {
-                break;
-            }
-        }
-    }
-
-    for (auto v: nodeSet) {
-        v->setVisited(false);
-    }
-    nodeSet[0]->setPath(nullptr);
-
-    dfsKruskalPath(nodeSet[0]);
-
-    return totalWeight;
-}
-
-double Graph::getEdgeWeight(Node* first, Node* second){
-    for(Edge* edge : first->getAdj()){
-        if(edge->getDest()==second){
-            return edge->getWeight();
-        }
-    }
-    return INF;
-}
-
-vector<Node*> Graph::joinSolvedTSP(vector<Node*> solved, vector<Node*> add, double& weight){
-    if(solved.empty()) return add;
-    if(add.empty()) return solved;
-
-    if(solved.size()!=1 && (solved.front()->getId()==solved.back()->getId()))solved.pop_back();
-    if(add.size()!=1 && (add.front()->getId()==add.back()->getId()))add.pop_back();
-
-
-    double min = std::numeric_limits<double>::max();
-    int minNode;
-    vector<Node*> joined;
-    int i = 0, k = 0, j=0, l = 0;
-
-    double curWeight = 0;
-    double dist;
-    for(Node* first : solved){
-        for(Node* second : add){
-            dist = getEdgeWeight(first, second);
-            if(dist < min){
-                min = dist;
-                k=i;
-                minNode = first->getId();
-                l = j;
-            }
-            j++;
-        }
-        i++;
-        j=0;
-    }
-
-    i = k;
-    j = l;
-    int prevI, prevJ = j;
-    bool firstIt= true;
-    i++;
-    while(true){
-        i %= solved.size();
-
-        if(!firstIt){
-            curWeight+= getEdgeWeight(solved[prevI], solved[i]);
-        } else firstIt=false;
-
-        if(solved[i]->getId()==minNode){
-            joined.push_back(solved[i]);
-            joined.push_back(add[j]);
-            curWeight += getEdgeWeight(solved[i],add[j]);
-            j++;
-            while(true){
-                j %= add.size();
-                curWeight += getEdgeWeight(add[prevJ],add[j]);
-                if(j==l) break;
-                joined.push_back(add[j]);
-                prevJ=j;
-                j++;
-            }
-            break;
-        }
-        else{
-            joined.push_back(solved[i]);
-            prevI = i;
-            i++;
-        }
-    }
-
-    curWeight+= getEdgeWeight(joined.back(), joined.front());
-    Node* newFront = joined[0];
-    joined.push_back(newFront);
-
-
-    weight = curWeight;
-
-    return joined;
-}
-
-void Graph::makeClusters(const vector<Node*>& centroids, vector<Node*>& cluster){
-    for(Node* node : cluster){
-        node->setDist(std::numeric_limits<double>::max());  // reset distance
-    }
-    for(Node* centroid : centroids){
-        for(Node* node : cluster){
-            double dist = haversineDistance(centroid->getLon(), centroid->getLat(), node->getLon(), node->getLat());
-            if(dist < node->getDist()){
-                node->setDist(dist);
-                node->setCluster(centroid->getClusterID());
-            }
-        }
-    }
-}
-
-vector<Node*> Graph::getCentroidCluster(Node* centroid, vector<Node*> const& cluster){
-    vector<Node*> result;
-    for(auto node : cluster){
-        if(node->getClusterID()==centroid->getClusterID()) result.push_back(node);
-    }
-    return result;
-}
-
-bool Graph::haveSimilarDistance(vector<Node*> const& cluster){
-    if(cluster.empty()) return false;
-    double long se = calculateStandardDeviation(cluster);
-    double long mean = calculateMean(cluster) * 0.1;
-
-    return se <= mean;
-}
-
-vector<Node*> Graph::kMeansDivideAndConquer(int k, vector<Node*> clusters, double& totalMin, bool firstIt){
-    if(k <= 0) return clusters;
-
-    if(!clusters.empty() && ((clusters.size()<=3 || haveSimilarDistance(clusters) || k <= 1))){
-        vector<Node*> result;
-        TriangularApproximationHeuristic(clusters, result,"real", "3");
-        return result;
-    }
-
-    if(clusters.empty()) clusters=NodeSet;
-    vector<Node*> firstSaved;
-    if(firstIt){
-        firstSaved.push_back(clusters[0]);
-        clusters.erase(clusters.begin());
-    }
-
-    vector<Node*> centroids;
-    srand(time(0));
-    for (int i = 0; i < k; i++) {
-        Node* random;
-        if(clusters.empty()) random = NodeSet[rand() % NodeSet.size()];
-        else random = clusters[rand() % clusters.size()];
-        Node* centroid = new Node(i, random->getLon(), random->getLat());
-        centroid->setCluster(i);
-        centroid->setIndegree(random->getId());
-        centroids.push_back(centroid);
-    }
-    makeClusters(centroids,clusters);
-
-
-    vector<int> nNodes;
-    vector<double> sumLon, sumLat;
-    bool doing = true;
-
-    while(doing){
-        makeClusters(centroids,clusters);
-        nNodes.clear();
-        sumLat.clear();
-        sumLon.clear();
-
-        for (int j = 0; j < k; ++j) {
-            nNodes.push_back(0);
-            sumLon.push_back(0.0);
-            sumLat.push_back(0.0);
-        }
-
-        for (Node* node : clusters) {
-            int clusterId = node->getClusterID();
-            nNodes[clusterId] += 1;
-            sumLon[clusterId] += node->getLon();
-            sumLat[clusterId] += node->getLat();
-        }
-
-        doing = false;
-        for(Node* c : centroids){
-            int clusterId = c->getClusterID();
-
-            double oldLon = c->getLon();
-            double oldLat = c->getLat();
-
-            if(nNodes[clusterId]==0){
-                Node* random;
-                if(clusters.empty())random = NodeSet[rand() % NodeSet.size()];
-                else random = clusters[rand() % clusters.size()];
-                c->setLon(random->getLon());
-                c->setLat(random->getLat());
-            } else{
-                c->setLon(sumLon[clusterId]/nNodes[clusterId]);
-                c->setLat(sumLat[clusterId]/nNodes[clusterId]);
-            }
-
-            if(oldLat!=c->getLat() || oldLon!=c->getLon())doing=true;
-
-        }
-    }
-
-
-    vector<Node*> solved, centroidCluster, recursion;
-    for(Node* c : centroids){
-        int clusterId = c->getClusterID();
-        centroidCluster = getCentroidCluster(c, clusters);
-        recursion = kMeansDivideAndConquer(sqrt(centroidCluster.size()),centroidCluster, totalMin, false);
-        for(Node* node : centroidCluster){
-            node->setCluster(clusterId);
-        }
-        solved = joinSolvedTSP(solved,recursion,totalMin);
-        delete c;
-    }
-    centroids.clear();
-    if(firstIt){
-        solved = joinSolvedTSP(firstSaved, solved, totalMin);
-
-    }
-    return solved;
-}
-
-
-
-void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
-    }
-}
-
-void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
-    }
-}
-
-Graph::~Graph() {
-    deleteMatrix(distMatrix, NodeSet.size());
-    deleteMatrix(pathMatrix, NodeSet.size());
+// By: Gonçalo Leão
+
+#include "Graph.h"
+#include "UFDS.h"
+#include "calculations.h"
+#include "parse.h"
+#include "ThreadPool.h"
+#include "TourStitcher.h"
+#include "Subgraph.h"
+#include "ParallelMST.h"
+#include "Stats.h"
+#include "MetricClosure.h"
+#include "ArtifactCache.h"
+#include "CompactBacktrack.h"
+#include <type_traits>
+
+using namespace std;
+
+void Graph::calculateMissingToyDistances(){
+    if(toyDistancesValid) return;
+    unsigned int n = NodeSet.size();
+    toyPosition.clear();
+    for(unsigned int i = 0; i < n; i++) toyPosition[NodeSet[i]->getId()] = i;
+
+    // the edges of each node, followed by the completed ones in the order they are found
+    toyDistances.assign((size_t) n * n, INF);
+    vector<vector<pair<unsigned int, double>>> adj(n);
+    for(unsigned int i = 0; i < n; i++){
+        for(Edge* edge : NodeSet[i]->getAdj()){
+            unsigned int j = toyPosition[edge->getDest()->getId()];
+            adj[i].emplace_back(j, edge->getWeight());
+            if(toyDistances[(size_t) i * n + j] == INF) toyDistances[(size_t) i * n + j] = edge->getWeight();
+        }
+    }
+
+    vector<bool> connected(n, false);
+    unsigned int isEverythingConnected = 0;
+    unsigned int i = 0;
+    while(isEverythingConnected != n){
+        if(adj[i].size() == n - 1 && !connected[i]){
+            isEverythingConnected++;
+            if(isEverythingConnected == n) break;
+            connected[i] = true;
+            continue;
+        }
+
+        vector<pair<unsigned int, double>> curAdj = adj[i]; // copies, as distances are added to the nodes while iterating
+        for(auto [nextNode, firstWeight] : curAdj){
+            vector<pair<unsigned int, double>> nextAdjs = adj[nextNode];
+            for(auto [finalNode, secondWeight] : nextAdjs){
+                if(finalNode == i) continue;
+
+                if(toyDistances[(size_t) i * n + finalNode] == INF){
+                    double weight = firstWeight + secondWeight;
+                    toyDistances[(size_t) i * n + finalNode] = weight;
+                    toyDistances[(size_t) finalNode * n + i] = weight;
+                    adj[i].emplace_back(finalNode, weight);
+                    adj[finalNode].emplace_back(i, weight);
+                }
+            }
+        }
+
+        if(i == n - 1) i = 0;
+        else i++;
+    }
+    toyDistancesValid = true;
+}
+
+bool Graph::calculateMetricClosure(){
+    if(closureValid) return true;
+    if(NodeSet.size() > MAX_CLOSURE_NODES) return false;
+    STATS_PHASE("metricClosure");
+    deleteMatrix(distMatrix, closureNodes.size());
+    deleteMatrix(pathMatrix, closureNodes.size());
+
+    unsigned int n = NodeSet.size();
+    closureNodes = NodeSet;
+    closurePosition.clear();
+    for(unsigned int i = 0; i < n; i++) closurePosition[NodeSet[i]->getId()] = i;
+    vector<PackedEdge> edges;
+    for(unsigned int i = 0; i < n; i++){
+        for(Edge* edge : NodeSet[i]->getAdj()){
+            edges.push_back({edge->getWeight(), i, closurePosition[edge->getDest()->getId()], 0});
+        }
+    }
+
+    distMatrix = new double*[n];
+    pathMatrix = new int*[n];
+    for(unsigned int i = 0; i < n; i++){
+        distMatrix[i] = new double[n];
+        pathMatrix[i] = new int[n];
+    }
+    MetricClosure(n, edges).run(distMatrix, pathMatrix);
+    closureValid = true;
+    return true;
+}
+
+bool Graph::hasMetricClosure() const{
+    return closureValid;
+}
+
+vector<Node*> Graph::getShortestPath(Node* from, Node* to) const{
+    vector<Node*> path;
+    if(!closureValid) return path;
+    auto i = closurePosition.find(from->getId()), j = closurePosition.find(to->getId());
+    if(i == closurePosition.end() || j == closurePosition.end() || distMatrix[i->second][j->second] == INF) return path;
+    for(int cur = j->second; cur != i->second; cur = pathMatrix[i->second][cur]){
+        path.push_back(closureNodes[cur]);
+    }
+    path.push_back(from);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+static_assert(std::is_trivially_destructible<Edge>::value, "edges are released with their slab, without destructors");
+
+void Graph::cleanGraph(){
+    for(Node* node : NodeSet){
+        node->~Node();
+    }
+    NodeSet.clear();
+    nodeSlab.release();
+    edgeSlab.release();
+    nodeIndex.clear();
+    nodeIndexValid = false;
+    oneWayEdges = 0;
+    edgeIndex.clear();
+    edgeIndexValid = false;
+    toyDistances.clear();
+    toyPosition.clear();
+    toyDistancesValid = false;
+    deleteMatrix(distMatrix, closureNodes.size());
+    deleteMatrix(pathMatrix, closureNodes.size());
+    distMatrix = nullptr;
+    pathMatrix = nullptr;
+    closurePosition.clear();
+    closureNodes.clear();
+    closureValid = false;
+    if(lazyEdges != nullptr) lazyEdges->clear();
+}
+
+static const uint32_t NO_REVERSE = UINT32_MAX;
+
+void Graph::serialize(std::string& out) const {
+    BinaryWriter writer(out);
+    unordered_map<const Node*, uint32_t> position;
+    unordered_map<const Edge*, uint32_t> edgePosition;   // edges are numbered node by node, in adjacency order
+    writer.put((uint32_t) NodeSet.size());
+    for(Node* node : NodeSet){
+        position.emplace(node, position.size());
+        writer.put((int32_t) node->getId());
+        writer.put(node->getLon());
+        writer.put(node->getLat());
+        writer.put((uint32_t) node->getAdj().size());
+        for(Edge* e : node->getAdj()) edgePosition.emplace(e, edgePosition.size());
+    }
+    for(Node* node : NodeSet){
+        for(Edge* e : node->getAdj()){
+            auto reverse = e->getReverse() != nullptr ? edgePosition.find(e->getReverse()) : edgePosition.end();
+            writer.put(position.at(e->getDest()));
+            writer.put(e->getWeight());
+            writer.put(reverse != edgePosition.end() ? reverse->second : NO_REVERSE);
+        }
+    }
+}
+
+bool Graph::deserialize(const std::string& in){
+    if(!NodeSet.empty()) return false;
+    BinaryReader reader(in);
+    uint32_t n;
+    if(!reader.get(n) || n > in.size() / 24) return false;     // a node takes 24 bytes, so n cannot be larger
+    vector<uint32_t> degree(n);
+    uint64_t totalEdges = 0;
+    for(uint32_t i = 0; i < n; i++){
+        int32_t id;
+        double lon, lat;
+        if(!reader.get(id) || !reader.get(lon) || !reader.get(lat) || !reader.get(degree[i])){
+            cleanGraph();
+            return false;
+        }
+        NodeSet.push_back(nodeSlab.create(id, lon, lat, &edgeSlab));
+        totalEdges += degree[i];
+    }
+    if(totalEdges > in.size() / 16){    // and an edge 16 bytes
+        cleanGraph();
+        return false;
+    }
+    vector<Edge*> edges;
+    vector<uint32_t> reverses;
+    edges.reserve(totalEdges);
+    reverses.reserve(totalEdges);
+    for(uint32_t i = 0; i < n; i++){
+        for(uint32_t j = 0; j < degree[i]; j++){
+            uint32_t dest, reverse;
+            double w;
+            if(!reader.get(dest) || !reader.get(w) || !reader.get(reverse) || dest >= n || (reverse != NO_REVERSE && reverse >= totalEdges)){
+                cleanGraph();
+                return false;
+            }
+            edges.push_back(NodeSet[i]->addEdge(NodeSet[dest], w));
+            reverses.push_back(reverse);
+        }
+    }
+    if(!reader.done()){
+        cleanGraph();
+        return false;
+    }
+    for(size_t e = 0; e < edges.size(); e++){
+        if(reverses[e] != NO_REVERSE) edges[e]->setReverse(edges[reverses[e]]);
+        else oneWayEdges++;
+    }
+    invalidateDistances();
+    edgeIndexValid = false;
+    return true;
+}
+
+void Graph::invalidateDistances(){
+    toyDistancesValid = false;
+    closureValid = false;
+}
+
+int Graph::getNumNode() const {
+    return NodeSet.size();
+}
+
+std::vector<Node *> Graph::getNodeSet() const {
+    return NodeSet;
+}
+
+
+Node * Graph::findNode(const int &id) const {
+    if (nodeIndexValid) {
+        auto it = nodeIndex.find(id);
+        return it != nodeIndex.end() ? it->second : nullptr;
+    }
+    for (auto v : NodeSet)
+        if (v->getId() == id)
+            return v;
+    return nullptr;
+}
+
+
+
+bool Graph::setStorage(Storage storage, double scale) {
+    if (!NodeSet.empty())
+        return false;
+    precision = Precision(storage, scale);
+    edgeIndex.reset(precision);
+    edgeIndexValid = false;
+    return true;
+}
+
+const Precision& Graph::getPrecision() const {
+    return precision;
+}
+
+bool Graph::addNode(const int &id, double longitude, double latitude) {
+    if (findNode(id) != nullptr)
+        return false;
+    NodeSet.push_back(nodeSlab.create(id, precision.coordinate(longitude), precision.coordinate(latitude), &edgeSlab));
+    if (nodeIndexValid) nodeIndex.emplace(id, NodeSet.back());
+    invalidateDistances();
+    return true;
+}
+
+void Graph::sortNodes(){
+    std::sort(NodeSet.begin(),NodeSet.end(),[](Node* a, Node* b){
+        return a->getId() < b->getId();
+    });
+}
+
+void Graph::sortEdges(){
+    for(Node* node : NodeSet){
+        node->sortEdges();
+    }
+}
+
+
+bool Graph::addEdge(const int &sourc, const int &dest, double w) {
+    auto v1 = findNode(sourc);
+    auto v2 = findNode(dest);
+    if (v1 == nullptr || v2 == nullptr)
+        return false;
+    w = precision.weight(w);
+    v1->addEdge(v2, w);
+    oneWayEdges++;
+    if (edgeIndexValid) indexEdge(sourc, dest, w);
+    invalidateDistances();
+    return true;
+}
+
+bool Graph::addBidirectionalEdge(const int &sourc, const int &dest, double w) {
+    auto v1 = findNode(sourc);
+    auto v2 = findNode(dest);
+    if (v1 == nullptr || v2 == nullptr)
+        return false;
+    addBidirectionalEdge(v1, v2, w);
+    return true;
+}
+
+Node* Graph::addNodeUnchecked(int id, double longitude, double latitude) {
+    NodeSet.push_back(nodeSlab.create(id, precision.coordinate(longitude), precision.coordinate(latitude), &edgeSlab));
+    if (nodeIndexValid) nodeIndex.emplace(id, NodeSet.back());
+    invalidateDistances();
+    return NodeSet.back();
+}
+
+void Graph::addBidirectionalEdge(Node* sourc, Node* dest, double w) {
+    w = precision.weight(w);
+    auto e1 = sourc->addEdge(dest, w);
+    auto e2 = dest->addEdge(sourc, w);
+    e1->setReverse(e2);
+    e2->setReverse(e1);
+    invalidateDistances();
+    if (edgeIndexValid) {
+        indexEdge(sourc->getId(), dest->getId(), w);
+        indexEdge(dest->getId(), sourc->getId(), w);
+    }
+}
+
+bool Graph::removeNode(const int &id) {
+    Node* node = findNode(id);
+    if (node == nullptr)
+        return false;
+    if (oneWayEdges == 0) {
+        // every edge into the node is the reverse of one of its own edges
+        for (Edge* e : node->getAdj()) {
+            Node* other = e->getDest();
+            if (other != node && other->removeEdge(id) && edgeIndexValid) edgeIndex.erase(other->getId(), id);
+        }
+    } else {
+        for (Node* other : NodeSet) {
+            if (other != node && other->removeEdge(id) && edgeIndexValid) edgeIndex.erase(other->getId(), id);
+        }
+    }
+    if (edgeIndexValid) {
+        for (Edge* e : node->getAdj()) edgeIndex.erase(id, e->getDest()->getId());
+    }
+    node->deleteAdj();
+    NodeSet.erase(std::find(NodeSet.begin(), NodeSet.end(), node));
+    if (nodeIndexValid) nodeIndex.erase(id);
+    node->~Node();
+    invalidateDistances();
+    if(lazyEdges != nullptr) lazyEdges->clear();   // the id may come back with other coordinates
+    return true;
+}
+
+bool Graph::zeroHasNoEdgesLeft(){
+    for(Edge* edge : NodeSet[0]->getAdj()){
+        if(!edge->getDest()->isVisited()) return false;
+    }
+    return true;
+}
+
+double Graph::tspBTRec(std::vector<Node *>& path, double min, double curCost, unsigned int i, unsigned int curPathSize, bool ended){
+    if(zeroHasNoEdgesLeft()) return min;
+    if(!NodeSet[i]->isVisited()){
+        if(curPathSize == NodeSet.size()-1){
+            double distToZero;
+            for(Edge* e : NodeSet[i]->getAdj()){
+                if(e->getDest()->getId()==0){
+                    distToZero=e->getWeight();
+                    break;
+                }
+            }
+            double sum = tspBTRec(path,min,curCost+distToZero,0,curPathSize,true);
+            if(sum < min && NodeSet[i]->getAdj()[0]->getDest()->getId()==0){
+                min = sum;
+                path[curPathSize] = NodeSet[i];
+            }
+            return min;
+        }
+        NodeSet[i]->setVisited(true);
+        STATS_COUNT(BB_EXPANSIONS, 1);
+        STATS_MAX(RECURSION_DEPTH, curPathSize);
+    }
+    else if(ended){
+        min = (curCost < min) ? curCost : min;
+        return min;
+    }
+    else return min;
+
+    for(Edge* edge: NodeSet[i]->getAdj()){
+        Node* node = edge->getDest();
+        if(curCost+edge->getWeight() >= min){
+            STATS_COUNT(BB_PRUNES, 1);
+            break;
+        }
+        double sum = tspBTRec(path,min,curCost+edge->getWeight(),node->getId(),curPathSize+1,false);
+        if (sum < min){
+            min = sum;
+            path[curPathSize] = NodeSet[i];
+        }
+    }
+
+    NodeSet[i]->setVisited(false);
+    return min;
+}
+
+double Graph::tspBT(std::vector<Node *>& path){
+    STATS_PHASE("bt/search");
+    if(CompactBacktrack::fits(*this)) return CompactBacktrack(*this).solve(path);
+    path = std::vector<Node *>(NodeSet.size(), 0);
+    for(int i = 0; i < NodeSet.size(); i++){
+        NodeSet[i]->setVisited(false);
+    }
+    double mean = tspBTRec(path,INT_MAX,0,0,0,false);
+    path.push_back(NodeSet[0]);
+    return mean;
+}
+
+void MatrixDistance::prepare(Graph& graph){
+    for(Node* node : graph.getNodeSet()){
+        node->setVisited(false);
+    }
+    if(!graph.calculateMetricClosure()) graph.calculateMissingToyDistances();
+}
+
+double MatrixDistance::step(const Graph& graph, Node* from, Node* to){
+    return graph.getDistance(from, to);
+}
+
+double MatrixDistance::close(const Graph& graph, Node* last, Node* first){
+    return graph.getDistance(last, first);
+}
+
+bool MatrixDistance::smallTour(const vector<Node*>&, vector<Node*>&, double&){
+    return false;
+}
+
+void ExplicitDistance::prepare(Graph&){}
+
+double ExplicitDistance::step(const Graph& graph, Node* from, Node* to){
+    return graph.getDistance(from, to);
+}
+
+double ExplicitDistance::close(const Graph&, Node* last, Node* first){
+    double weight = 0;
+    for(auto e : last->getAdj()){
+        if(e->getDest()==first){
+            weight+=e->getWeight();
+        }
+    }
+    return weight;
+}
+
+bool ExplicitDistance::smallTour(const vector<Node*>&, vector<Node*>&, double&){
+    return false;
+}
+
+void GeographicDistance::prepare(Graph&){}
+
+double GeographicDistance::step(const Graph& graph, Node* from, Node* to){
+    return graph.getDistance(from, to);
+}
+
+double GeographicDistance::close(const Graph& graph, Node* last, Node* first){
+    return graph.getPrecision().weight(haversineDistance(last->getLon(),last->getLat(),first->getLon(),first->getLat()));
+}
+
+bool GeographicDistance::smallTour(const vector<Node*>& nodeSet, vector<Node*>& tour, double& weight){
+    if(nodeSet.empty() || nodeSet.size() > 3) return false;
+    for(Node* node : nodeSet) tour.push_back(node);
+    if(nodeSet.size() > 1) tour.push_back(nodeSet[0]);
+    weight = 0;
+    for(int i = 0; i + 1 < tour.size(); i++){
+        weight += haversineDistance(tour[i]->getLon(),tour[i]->getLat(),tour[i+1]->getLon(),tour[i+1]->getLat());
+    }
+    return true;
+}
+
+template<typename Distance>
+void Graph::preOrder(Node* node,std::vector<Node*>& mst, bool firstIt, double& weight){
+    if(node== nullptr)return;
+    STATS_PHASE("preOrder");
+    if(firstIt) mst.push_back(node);
+
+    vector<pair<Node*, unsigned int>> stack = {{node, 0}}; // (node, next outgoing edge to look at)
+    while(!stack.empty()){
+        auto& [cur, e] = stack.back();
+        const vector<Edge*>& adj = cur->getAdj();
+        if(e == adj.size()){
+            stack.pop_back();
+            continue;
+        }
+        Edge* edge = adj[e++];
+        Node* nextNode = edge->getDest();
+
+        if(edge->isSelected() && nextNode->getPath() == edge){
+            Node* last = mst.back();
+            mst.push_back(nextNode);
+            weight += Distance::step(*this, last, nextNode);
+            stack.emplace_back(nextNode, 0);
+        }
+    }
+}
+
+template<typename Distance, typename Scope>
+double Graph::TriangularApproximationHeuristic(vector<Node*> nodeSet,std::vector<Node*>& L){
+    double weight = 0;
+    if(Distance::smallTour(nodeSet, L, weight)) return weight;
+
+    if constexpr(std::is_same_v<Scope, Cluster>){
+        Subgraph cluster(*this, nodeSet);
+        cluster.kruskal();
+        return cluster.preOrder(L);
+    } else {
+        for(Node* node : NodeSet){
+            node->setPath(nullptr);
+            node->setVisited(false);
+        }
+
+        kruskal();
+        Distance::prepare(*this);
+
+        preOrder<Distance>(NodeSet[0],L,true, weight);
+
+        Node* last = L.back();
+        Node* zero = L.front();
+        weight += Distance::close(*this, last, zero);
+        L.push_back(zero);
+
+        return weight;
+    }
+}
+
+double Graph::TriangularApproximationHeuristic(vector<Node*> nodeSet,std::vector<Node*>& L, const string& type){
+    if(type == "toy") return TriangularApproximationHeuristic<MatrixDistance>(std::move(nodeSet), L);
+    if(type == "real") return TriangularApproximationHeuristic<GeographicDistance>(std::move(nodeSet), L);
+    return TriangularApproximationHeuristic<ExplicitDistance>(std::move(nodeSet), L);
+}
+
+template void Graph::preOrder<MatrixDistance>(Node*, std::vector<Node*>&, bool, double&);
+template void Graph::preOrder<ExplicitDistance>(Node*, std::vector<Node*>&, bool, double&);
+template void Graph::preOrder<GeographicDistance>(Node*, std::vector<Node*>&, bool, double&);
+template double Graph::TriangularApproximationHeuristic<MatrixDistance, WholeGraph>(vector<Node*>, std::vector<Node*>&);
+template double Graph::TriangularApproximationHeuristic<MatrixDistance, Cluster>(vector<Node*>, std::vector<Node*>&);
+template double Graph::TriangularApproximationHeuristic<ExplicitDistance, WholeGraph>(vector<Node*>, std::vector<Node*>&);
+template double Graph::TriangularApproximationHeuristic<ExplicitDistance, Cluster>(vector<Node*>, std::vector<Node*>&);
+template double Graph::TriangularApproximationHeuristic<GeographicDistance, WholeGraph>(vector<Node*>, std::vector<Node*>&);
+template double Graph::TriangularApproximationHeuristic<GeographicDistance, Cluster>(vector<Node*>, std::vector<Node*>&);
+
+void Graph::dfsKruskalPath(Node *v) {
+    v->setVisited(true);
+    vector<pair<Node*, unsigned int>> stack = {{v, 0}}; // (node, next outgoing edge to look at)
+    while (!stack.empty()) {
+        auto& [cur, i] = stack.back();
+        const vector<Edge*>& adj = cur->getAdj();
+        if (i == adj.size()) {
+            stack.pop_back();
+            continue;
+        }
+        Edge* e = adj[i++];
+        if (e->isSelected() && !e->getDest()->isVisited()) {
+            e->getDest()->setVisited(true);
+            e->getDest()->setPath(e);
+            stack.emplace_back(e->getDest(), 0);
+        }
+    }
+}
+
+double Graph::kruskal() {
+    STATS_PHASE("kruskal");
+    std::vector<Edge*> edgeRefs;
+    std::vector<PackedEdge> packedEdges;
+    unordered_map<const Node*, unsigned int> position;     // ids stop matching positions once a node is removed
+    position.reserve(NodeSet.size());
+    for (unsigned int i = 0; i < NodeSet.size(); i++) {
+        position.emplace(NodeSet[i], i);
+    }
+    for (auto v: NodeSet) {
+        for (auto e: v->getAdj()) {
+            e->setSelected(false);
+            if (e->getOrig()->getId() < e->getDest()->getId()) {
+                packedEdges.push_back({e->getWeight(), position.at(e->getOrig()), position.at(e->getDest()), (unsigned int) edgeRefs.size()});
+                edgeRefs.push_back(e);
+            }
+        }
+    }
+
+    ParallelMST mst(NodeSet.size(), std::move(packedEdges));
+    double totalWeight = mst.run();
+    for (unsigned int id : mst.getSelected()) {
+        edgeRefs[id]->setSelected(true);
+        edgeRefs[id]->getReverse()->setSelected(true);
+    }
+
+    for (auto v: NodeSet) {
+        v->setVisited(false);
+    }
+    NodeSet[0]->setPath(nullptr);
+
+    dfsKruskalPath(NodeSet[0]);
+
+    return totalWeight;
+}
+
+double Graph::kruskalEx3(vector<Node*>& nodeSet){
+    Subgraph cluster(*this, nodeSet);
+    double totalWeight = cluster.kruskal();
+
+    for (auto v: nodeSet) {
+        for (auto e: v->getAdj()) {
+            e->setSelected(false);
+        }
+    }
+    for (Edge* e : cluster.getSelectedEdges()) {
+        e->setSelected(true);
+        e->getReverse()->setSelected(true);
+    }
+
+    for (auto v: nodeSet) {
+        v->setVisited(false);
+    }
+    nodeSet[0]->setPath(nullptr);
+
+    dfsKruskalPath(nodeSet[0]);
+
+    return totalWeight;
+}
+
+double Graph::getEdgeWeight(Node* first, Node* second){
+    for(Edge* edge : first->getAdj()){
+        if(edge->getDest()==second){
+            return edge->getWeight();
+        }
+    }
+    return INF;
+}
+
+void Graph::indexEdge(int orig, int dest, double w){
+    edgeIndex.insert(orig, dest, w);
+}
+
+void Graph::indexEdges(){
+    edgeIndex.clear();
+    for(Node* node : NodeSet){
+        for(Edge* edge : node->getAdj()){
+            indexEdge(node->getId(), edge->getDest()->getId(), edge->getWeight());
+        }
+    }
+    edgeIndexValid = true;
+}
+
+bool Graph::isEdgeIndexed() const{
+    return edgeIndexValid;
+}
+
+void Graph::indexNodes(){
+    nodeIndex.clear();
+    nodeIndex.reserve(NodeSet.size());
+    for(Node* node : NodeSet) nodeIndex.emplace(node->getId(), node);
+    nodeIndexValid = true;
+}
+
+bool Graph::isNodeIndexed() const{
+    return nodeIndexValid;
+}
+
+double Graph::getDistance(Node* first, Node* second) const{
+    if(first == second) return 0;
+    STATS_COUNT(DISTANCE_EVALUATIONS, 1);
+    double dist;
+    if(edgeIndexValid) dist = edgeIndex.find(first->getId(), second->getId());
+    else dist = getEdgeWeight(first, second);
+    if(dist == INF && closureValid){
+        auto i = closurePosition.find(first->getId()), j = closurePosition.find(second->getId());
+        if(i != closurePosition.end() && j != closurePosition.end()) dist = distMatrix[i->second][j->second];
+    }
+    if(dist == INF && toyDistancesValid){
+        auto i = toyPosition.find(first->getId()), j = toyPosition.find(second->getId());
+        if(i != toyPosition.end() && j != toyPosition.end()) dist = toyDistances[(size_t) i->second * toyPosition.size() + j->second];
+    }
+    if(dist != INF) return dist;
+    if(lazyEdges != nullptr && lazyEdges->find(first->getId(), second->getId(), dist)) return dist;
+    dist = precision.weight(haversineDistance(first->getLon(), first->getLat(), second->getLon(), second->getLat()));
+    if(lazyEdges != nullptr) lazyEdges->insert(first->getId(), second->getId(), dist);
+    return dist;
+}
+
+void Graph::setLazyEdges(std::size_t capacity){
+    if(capacity == 0) lazyEdges.reset();
+    else lazyEdges = std::make_unique<LazyEdgeCache>(capacity);
+}
+
+const LazyEdgeCache* Graph::getLazyEdges() const{
+    return lazyEdges.get();
+}
+
+size_t Graph::memoryBytes() const{
+    size_t edges = 0;
+    for(Node* node : NodeSet) edges += node->getAdj().size();
+    size_t bytes = NodeSet.size() * (sizeof(Node) + sizeof(Node*)) + edges * (sizeof(Edge) + sizeof(Edge*));
+    bytes += edgeIndex.memoryBytes() + toyDistances.size() * sizeof(double);
+    bytes += nodeIndex.size() * (sizeof(std::pair<const int, Node*>) + sizeof(void*)) + nodeIndex.bucket_count() * sizeof(void*);
+    bytes += closureNodes.size() * closureNodes.size() * (sizeof(double) + sizeof(int));
+    if(lazyEdges != nullptr) bytes += lazyEdges->memoryBytes();
+    return bytes;
+}
+
+double Graph::getTourWeight(const vector<Node*>& tour) const{
+    if(tour.size() < 2) return 0;
+    WeightSum weight(precision);
+    for(int i = 0; i + 1 < tour.size(); i++){
+        weight.add(getDistance(tour[i], tour[i+1]));
+    }
+    if(tour.front() != tour.back()) weight.add(getDistance(tour.back(), tour.front()));
+    return weight.value();
+}
+
+vector<Node*> Graph::joinSolvedTSP(vector<Node*> solved, vector<Node*> add, double& weight){
+    if(solved.empty()) return add;
+    if(add.empty()) return solved;
+
+    if(solved.size()!=1 && (solved.front()->getId()==solved.back()->getId()))solved.pop_back();
+    if(add.size()!=1 && (add.front()->getId()==add.back()->getId()))add.pop_back();
+
+
+    double min = std::numeric_limits<double>::max();
+    int minNode;
+    vector<Node*> joined;
+    int i = 0, k = 0, j=0, l = 0;
+
+    double curWeight = 0;
+    double dist;
+    for(Node* first : solved){
+        for(Node* second : add){
+            dist = getEdgeWeight(first, second);
+            if(dist < min){
+                min = dist;
+                k=i;
+                minNode = first->getId();
+                l = j;
+            }
+            j++;
+        }
+        i++;
+        j=0;
+    }
+
+    i = k;
+    j = l;
+    int prevI, prevJ = j;
+    bool firstIt= true;
+    i++;
+    while(true){
+        i %= solved.size();
+
+        if(!firstIt){
+            curWeight+= getEdgeWeight(solved[prevI], solved[i]);
+        } else firstIt=false;
+
+        if(solved[i]->getId()==minNode){
+            joined.push_back(solved[i]);
+            joined.push_back(add[j]);
+            curWeight += getEdgeWeight(solved[i],add[j]);
+            j++;
+            while(true){
+                j %= add.size();
+                curWeight += getEdgeWeight(add[prevJ],add[j]);
+                if(j==l) break;
+                joined.push_back(add[j]);
+                prevJ=j;
+                j++;
+            }
+            break;
+        }
+        else{
+            joined.push_back(solved[i]);
+            prevI = i;
+            i++;
+        }
+    }
+
+    curWeight+= getEdgeWeight(joined.back(), joined.front());
+    Node* newFront = joined[0];
+    joined.push_back(newFront);
+
+
+    weight = curWeight;
+
+    return joined;
+}
+
+void Graph::makeClusters(const vector<Node*>& centroids, vector<Node*>& cluster){
+    STATS_COUNT(DISTANCE_EVALUATIONS, centroids.size() * cluster.size());
+    for(Node* node : cluster){
+        node->setDist(std::numeric_limits<double>::max());  // reset distance
+    }
+    for(Node* centroid : centroids){
+        for(Node* node : cluster){
+            double dist = haversineDistance(centroid->getLon(), centroid->getLat(), node->getLon(), node->getLat());
+            if(dist < node->getDist()){
+                node->setDist(dist);
+                node->setCluster(centroid->getClusterID());
+            }
+        }
+    }
+}
+
+vector<Node*> Graph::getCentroidCluster(Node* centroid, vector<Node*> const& cluster){
+    vector<Node*> result;
+    for(auto node : cluster){
+        if(node->getClusterID()==centroid->getClusterID()) result.push_back(node);
+    }
+    return result;
+}
+
+bool Graph::haveSimilarDistance(vector<Node*> const& cluster){
+    if(cluster.empty()) return false;
+    double long se = calculateStandardDeviation(cluster);
+    double long mean = calculateMean(cluster) * 0.1;
+
+    return se <= mean;
+}
+
+vector<Node*> Graph::kMeansDivideAndConquer(int k, vector<Node*> clusters, double& totalMin, bool firstIt, unsigned int seed){
+    if(!edgeIndexValid) indexEdges();
+    return kMeansRec(k, clusters, totalMin, firstIt, seed != 0 ? seed : time(0));
+}
+
+vector<Node*> Graph::kMeansRec(int k, vector<Node*> clusters, double& totalMin, bool firstIt, unsigned int seed, unsigned int depth){
+    STATS_MAX(RECURSION_DEPTH, depth);
+    if(k <= 0) return clusters;
+
+    if(!clusters.empty() && ((clusters.size()<=3 || haveSimilarDistance(clusters) || k <= 1))){
+        STATS_PHASE("kmeans/leaf");
+        vector<Node*> result;
+        TriangularApproximationHeuristic<GeographicDistance, Cluster>(clusters, result);
+        totalMin = getTourWeight(result);
+        return result;
+    }
+
+    if(clusters.empty()) clusters=NodeSet;
+    vector<Node*> firstSaved;
+    if(firstIt){
+        firstSaved.push_back(clusters[0]);
+        clusters.erase(clusters.begin());
+    }
+
+    vector<Node*> centroids;
+    mt19937 rng(seed);
+    for (int i = 0; i < k; i++) {
+        Node* random;
+        if(clusters.empty()) random = NodeSet[rng() % NodeSet.size()];
+        else random = clusters[rng() % clusters.size()];
+        Node* centroid = new Node(i, random->getLon(), random->getLat());
+        centroid->setCluster(i);
+        centroids.push_back(centroid);
+    }
+    makeClusters(centroids,clusters);
+
+
+    vector<int> nNodes;
+    vector<double> sumLon, sumLat;
+    bool doing = true;
+
+    {
+        STATS_PHASE("kmeans/clustering");
+        while(doing){
+            STATS_COUNT(KMEANS_ITERATIONS, 1);
+            makeClusters(centroids,clusters);
+            nNodes.clear();
+            sumLat.clear();
+            sumLon.clear();
+
+            for (int j = 0; j < k; ++j) {
+                nNodes.push_back(0);
+                sumLon.push_back(0.0);
+                sumLat.push_back(0.0);
+            }
+
+            for (Node* node : clusters) {
+                int clusterId = node->getClusterID();
+                nNodes[clusterId] += 1;
+                sumLon[clusterId] += node->getLon();
+                sumLat[clusterId] += node->getLat();
+            }
+
+            doing = false;
+            for(Node* c : centroids){
+                int clusterId = c->getClusterID();
+
+                double oldLon = c->getLon();
+                double oldLat = c->getLat();
+
+                if(nNodes[clusterId]==0){
+                    Node* random;
+                    if(clusters.empty())random = NodeSet[rng() % NodeSet.size()];
+                    else random = clusters[rng() % clusters.size()];
+                    c->setLon(random->getLon());
+                    c->setLat(random->getLat());
+                } else{
+                    c->setLon(sumLon[clusterId]/nNodes[clusterId]);
+                    c->setLat(sumLat[clusterId]/nNodes[clusterId]);
+                }
+
+                if(oldLat!=c->getLat() || oldLon!=c->getLon())doing=true;
+
+            }
+        }
+    }
+
+
+    ThreadPool& pool = ThreadPool::shared();
+    vector<vector<Node*>> centroidClusters;
+    vector<double> clusterMin(centroids.size(), 0);
+    vector<future<vector<Node*>>> recursions;
+    for(Node* c : centroids){
+        centroidClusters.push_back(getCentroidCluster(c, clusters));
+    }
+    for(int c = 0; c < centroids.size(); c++){
+        unsigned int clusterSeed = rng();
+        recursions.push_back(pool.submit([this, &centroidClusters, &clusterMin, c, clusterSeed, depth](){
+            const vector<Node*>& centroidCluster = centroidClusters[c];
+            return kMeansRec(sqrt(centroidCluster.size()), centroidCluster, clusterMin[c], false, clusterSeed, depth + 1);
+        }));
+    }
+
+    TourStitcher stitcher(*this);
+    vector<Node*> solved, recursion;
+    totalMin = 0;
+    for(int c = 0; c < centroids.size(); c++){
+        int clusterId = centroids[c]->getClusterID();
+        recursion = pool.wait(recursions[c]);
+        for(Node* node : centroidClusters[c]){
+            node->setCluster(clusterId);
+        }
+        totalMin = stitcher.join(solved, totalMin, recursion, clusterMin[c]);
+        delete centroids[c];
+    }
+    centroids.clear();
+    if(firstIt){
+        totalMin = stitcher.join(firstSaved, 0, solved, totalMin);
+        solved.swap(firstSaved);
+        solved.push_back(solved.front());
+    }
+    return solved;
+}
+
+
+
+void deleteMatrix(int **m, int n) {
+    if (m != nullptr) {
+        for (int i = 0; i < n; i++)
+            if (m[i] != nullptr)
+                delete [] m[i];
+        delete [] m;
+    }
+}
+
+void deleteMatrix(double **m, int n) {
+    if (m != nullptr) {
+        for (int i = 0; i < n; i++)
+            if (m[i] != nullptr)
+                delete [] m[i];
+        delete [] m;
+    }
+}
+
+Graph::~Graph() {
+    cleanGraph();
 }
\ No newline at end of file
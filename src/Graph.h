@@ -1,220 +1,486 @@
-// By: Gonçalo Leão
-
-#ifndef DA_TP_CLASSES_GRAPH
-#define DA_TP_CLASSES_GRAPH
-
-#include <iostream>
-#include <vector>
-#include <queue>
-#include <limits>
-#include <algorithm>
-#include "calculations.h"
-#include <string>
-
-
-#include "NodeEdge.h"
-
-using namespace std;
-
-class Graph {
-public:
-    /**
-     * Default destructor of the Graph class.
-     */
-    ~Graph();
-    /**
-     * Loops through the NodeSet to check if a node with the id given as parameter exists.
-     * @param id Represents the id of the node
-     * @return Node* if it exists in the NodeSet, nullptr otherwise.
-     * @note Time-complexity -> O(V) with V being the size of the NodeSet
-     */
-    [[nodiscard]] Node* findNode(const int &id) const;
-    /**
-     * Adds a node with id, longitude and latitude passed as parameter to the NodeSet.
-     * @param id Represents the id of the node to be added
-     * @param longitude Represents the longitude of the node to be added. Default is 0
-     * @param latitude Represents the latitude of the node to be added. Default is 0
-     * @return True if the node with those values does not exist in the NodeSet, false otherwise.
-     * @note Time-complexity -> O(V) with V being the size of the NodeSet
-     */
-    bool addNode(const int &id, double longitude = 0, double latitude=0);
-    /**
-     * Returns the number of nodes in the (this) graph.
-     * @return The size of the NodeSet
-     * @note Time-complexity -> O(1)
-     */
-    [[nodiscard]] int getNumNode() const;
-    /**
-     * Returns the vector NodeSet of the (this) graph.
-     * @return vector with the nodes belonging to the (this) graph
-     * @note Time-complexity -> O(1)
-     */
-    [[nodiscard]] vector<Node *> getNodeSet() const;
-    /**
-     * Sorts the nodes of the (this) graph from lowest to highest
-     * @note Time-complexity -> O(n*log(n))
-     */
-    void sortNodes();
-    /**
-     * Sorts the edges of the (this) graph from lowest to highest
-     * @note Time-complexity -> O(n*log(n))
-     */
-    void sortEdges();
-    /**
-     * Adds an edge to the (this) graph, with origin, destination and weight passed as parameters.
-     * @param sourc Represents the origin of the edge
-     * @param dest Represents the destination of the edge
-     * @param w Represents the weight of the edge
-     * @return True if an edge with that information doesn't exist in the NodeSet, false otherwise.
-     * @note Time-complexity -> O(V) with V being the size of the NodeSet
-     *
-     */
-    bool addEdge(const int &sourc, const int &dest, double w);
-    /**
-     * Adds a bidirectional edge to the (this) graph, with origin, destination and weight passed as parameters.
-     * @param sourc Represents one of the nodes of the edge
-     * @param dest Represents one of the nodes of the edge
-     * @param w Represents the weight of the edge
-     * @return True if an edge with that information doesn't exist in the NodeSet, false otherwise.
-     * @note Time-complexity -> O(V) with V being the size of the NodeSet
-     */
-    bool addBidirectionalEdge(const int &sourc, const int &dest, double w);
-    /**
-     * Deletes the nodes and edges of the (this) graph.
-     * @note Time-complexity -> O(V+E) with V being the size of the NodeSet and E being the number of edges of each node
-     */
-    void cleanGraph();
-    /**
-    * Calculates and adds the missing edges to turn a toy graph into a fully connected graph. Bases the calculations on the triangular inequality property, the sum of the lengths of any two sides must be greater than or equal to the length of the remaining side.
-    * @note Time-complexity -> O(V^2 * U) where U is the number of nodes not fully connected
-    */
-    void calculateMissingToyDistances();
-    /**
-     * Checks if node 0 has any adjacent edge that is yet to be visited.
-     * @return False if it finds any unvisited node, true otherwise.
-     * @note Time-complexity -> O(E) with E being the number of outgoing edges from node 0
-     */
-    bool zeroHasNoEdgesLeft();
-    /**
-     * Implementation of the backtracking algorithm. Calculates the optimal path for the (this) graph and returns the weight of said path.
-     * @param path Represents the path taken
-     * @param min Represents the minimum cost of the paths travelled so far
-     * @param curCost Represents the current cost of the path taken
-     * @param i Represents the id of the node
-     * @param curPathSize Represents the current path size
-     * @param ended Checks if the end of the path has been reached
-     * @return The minimum cost of the paths travelled
-     * @note Time-complexity -> O((n-1)!*E) with n being the number of nodes in the graph
-     */
-    double tspBTRec(std::vector<Node *>& path, double min, double curCost, unsigned int i, unsigned int curPathSize, bool ended);
-    /**
-     * Fills the vector path with the size of the NodeSet and initialises it with 0's, also iterates over the
-     * NodeSet and sets every node's visited field as false. Returns the result of the tspBTRec, a.k.a the recursive function
-     * that implements the backtracking algorithm.
-     * @param path Is initially sent as an empty vector. At the end of the function call, represents the optimal path.
-     * @return The weight of the optimal path
-     * @note Time-complexity -> O((n-1)!*E) with n being the number of nodes in the graph
-     */
-    double tspBT(std::vector<Node *>& path);
-    /**
-     * Creates an MST by visiting the (this) graph in preOrder, starting with the node provided as parameter. Stores the sum of
-     * the edges of the MST in the weight variable passed as parameter.
-     * @param node Represents the first node to be visited
-     * @param mst Represents the nodes belonging to the MST
-     * @param firstIt Checks if the function is in its first iteration. True if it is, false otherwise
-     * @param weight Represents the sum of the edges of the MST
-     * @param ex Represents which exercise this function is being used for
-     * @note Time-complexity -> O(E+N) with E being the outgoing edges of the node parameter and N the number of nodes in the graph
-     */
-    void preOrder(Node* node,std::vector<Node*>& mst, bool firstIt, double& weight, const string& ex);
-    /**
-     * Implementation of the triangular approximation heuristic. Utilizes the triangular inequality law to approximate a value
-     * close to the optimal one, in return for more efficiency.
-     * @param nodeSet Represents the NodeSet of the (this) graph
-     * @param mst Represents the nodes belonging to the MST
-     * @param type Represents the type of graph
-     * @param ex Represents which exercise this function is being used for
-     * @return The weight of the path taken
-     * @note Time-complexity -> O(N*E + E*log(E)), where N is the size of the nodeSet vector and E is the number of edges in the graph.
-     */
-    double TriangularApproximationHeuristic(vector<Node*> nodeSet, std::vector<Node*>& mst,const std::string& type, const std::string& ex);
-    /**
-     * Implementation of the kruskal algorithm. Creates an MST and returns the sum of the weight of the selected edges.
-     * @return The sum of the weight of the edges of the MST
-     * @note Time-complexity -> O(N*E + E*log(E)), where N is the number of nodes and E is the number of edges
-     */
-    double kruskal();
-    /**
-     * Depth-first Search used in the implementation of the kruskal algorithm.
-     * @param v Represents a node which edges will be used in the DFS
-     * @note Time-complexity -> O(E) where E is the number of edges of the v node
-     */
-    void dfsKruskalPath(Node *v);
-    /**
-     * Implementation of the kruskal algorithm, specific to the 3rd exercise.
-     * @param nodeSet Represents a cluster of nodes
-     * @return The sum of the weight of the edges of the MST
-     * @note Time-complexity -> O(N*E + E*log(E)), where N is the number of nodes and E is the number of edges
-     */
-    double kruskalEx3(vector<Node*>& nodeSet);
-    /**
-     * Returns the weight of the edge between the two nodes passed as parameters.
-     * @param first Represents one of the nodes of the edge
-     * @param second Represents one of the nodes of the edge
-     * @return The weight of the edge if it exists, INF otherwise
-     * @note Time-complexity -> O(E) with E being the number of outgoing edges of the first node
-     */
-    static double getEdgeWeight(Node* first, Node* second);
-    /**
-     * Calculates the best nodes to link two clusters with solved hamiltonian cycles and merges the two clusters. Stores the
-     * weight of the hamiltonian cycle in the variable weight passed as parameter.
-     * @param solved Represents one of the clusters to be merged
-     * @param add Represents one of the clusters to be merged
-     * @param weight Represents the weight of the hamiltonian cycle of the merged clusters
-     * @return Merged cluster of the solved and add clusters
-     * @note Time-complexity -> O(S * A + S + A) with S being the size of solved vector and A the size of the add vector
-     */
-    static vector<Node*> joinSolvedTSP(std::vector<Node*> solved, std::vector<Node*> add, double& weight);
-    /**
-     * Creates clusters with a centroid in the center of each cluster.
-     * @param centroids Represents the centroids created randomly
-     * @param cluster Represents the cluster in which the clusters will be created
-     * @note Time-complexity -> O(C + K * C) with C being the size of the cluster vector and K the size of the centroids vector
-     */
-    static void makeClusters(const std::vector<Node*>&centroids, vector<Node*>& cluster);
-    /**
-     * Returns the cluster of a centroid
-     * @param centroid Represents the centroid of a cluster
-     * @param cluster Represents a cluster of nodes
-     * @return vector&lt Node*> with every node pertaining to the cluster of a centroid
-     * @note Time-complexity -> O(n) with n being the size of the cluster vector
-     */
-    static vector<Node*> getCentroidCluster(Node* centroid, vector<Node*> const& cluster);
-    /**
-     * Checks if the nodes of a cluster have similar distance by analysing the mean and standard deviation of their distances.
-     * @param cluster Represents a cluster of nodes
-     * @return True if the standard deviation is less or equal than 10% of the mean of the nodes' distances
-     * @note Time-complexity -> O(1)
-     */
-    static bool haveSimilarDistance(const vector<Node*>& cluster);
-    /**
-     * Implementation of the k-means algorithm using a divide and conquer approach.
-     * @param k Represents the number of clusters created in each iteration of this algorithm
-     * @param clusters Represents the current cluster of nodes
-     * @param totalMin Represents the total weight of the path of the clusters variable
-     * @param firstIt Checks if the function is in its first iteration. True if it is, false otherwise
-     * @return The path solved by the approximation heuristic
-     * @note Time-complexity -> O((C + K * C) * log(K)) with C being the size of the clusters vector and K the size of the centroids vector
-     */
-    vector<Node*> kMeansDivideAndConquer(int k, std::vector<Node*> clusters, double& totalMin, bool firstIt);
-protected:
-    std::vector<Node *> NodeSet;    // Node set
-
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
-};
-
-void deleteMatrix(int **m, int n);
-void deleteMatrix(double **m, int n);
-
-#endif /* DA_TP_CLASSES_GRAPH */
+// By: Gonçalo Leão
+
+#ifndef DA_TP_CLASSES_GRAPH
+#define DA_TP_CLASSES_GRAPH
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <climits>
+#include <algorithm>
+#include "calculations.h"
+#include <string>
+#include <random>
+#include <unordered_map>
+
+
+#include "NodeEdge.h"
+#include "EdgeIndex.h"
+#include "LazyEdgeCache.h"
+#include "Precision.h"
+
+using namespace std;
+
+class Graph;
+
+/**
+ * Distance policies of TriangularApproximationHeuristic and preOrder, picked at compile time instead of by the type of
+ * the graph. Each gives the distance of a step of the preorder walk, the distance that closes the tour, the work done on
+ * the graph before the walk and, for the small node sets, the tour solved directly.
+ */
+/**
+ * Toy graphs: the distances missing from the edges are completed into a matrix (metric closure, or the triangular
+ * completion if the graph is too large) before the walk, and read back by getDistance.
+ */
+struct MatrixDistance {
+    static void prepare(Graph& graph);
+    static double step(const Graph& graph, Node* from, Node* to);
+    static double close(const Graph& graph, Node* last, Node* first);
+    static bool smallTour(const vector<Node*>& nodeSet, vector<Node*>& tour, double& weight);
+};
+/**
+ * Fully connected graphs: the tour is closed by the edge between its ends.
+ */
+struct ExplicitDistance {
+    static void prepare(Graph& graph);
+    static double step(const Graph& graph, Node* from, Node* to);
+    static double close(const Graph& graph, Node* last, Node* first);
+    static bool smallTour(const vector<Node*>& nodeSet, vector<Node*>& tour, double& weight);
+};
+/**
+ * Real-world graphs: the tour is closed by the haversine distance between its ends, and the node sets of up to 3 nodes
+ * are solved by their coordinates alone.
+ */
+struct GeographicDistance {
+    static void prepare(Graph& graph);
+    static double step(const Graph& graph, Node* from, Node* to);
+    static double close(const Graph& graph, Node* last, Node* first);
+    static bool smallTour(const vector<Node*>& nodeSet, vector<Node*>& tour, double& weight);
+};
+/**
+ * Scope policies of TriangularApproximationHeuristic: the whole graph, with a closed tour, or a cluster of it, solved on
+ * a Subgraph with an open tour.
+ */
+struct WholeGraph {};
+struct Cluster {};
+
+class Graph {
+public:
+    /**
+     * Destructor of the Graph class. Deletes the nodes and edges of the graph and the matrices.
+     */
+    ~Graph();
+    /**
+     * Loops through the NodeSet to check if a node with the id given as parameter exists, or looks it up in the index
+     * built by indexNodes if it is up to date.
+     * @param id Represents the id of the node
+     * @return Node* if it exists in the NodeSet, nullptr otherwise.
+     * @note Time-complexity -> O(1) on average if the nodes are indexed, O(V) otherwise with V being the size of the NodeSet
+     */
+    [[nodiscard]] Node* findNode(const int &id) const;
+    /**
+     * Sets how the weights and coordinates of the (this) graph are stored (see Storage). Must be called while the graph is
+     * empty, e.g. before loading a dataset; from then on every coordinate, weight and distance given by getDistance is
+     * rounded to the precision of the mode, and the edge index keeps its weights in the compact form of the mode.
+     * @param storage Represents the storage mode
+     * @param scale Represents the number of fixed-point units per unit of weight, only used by FIXED_POINT
+     * @return True if the graph was empty, false otherwise (and the mode is left unchanged)
+     * @note Time-complexity -> O(1)
+     */
+    bool setStorage(Storage storage, double scale = Precision::DEFAULT_SCALE);
+    /**
+     * Returns the precision the weights and coordinates of the (this) graph are stored with.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const Precision& getPrecision() const;
+    /**
+     * Adds a node with id, longitude and latitude passed as parameter to the NodeSet.
+     * @param id Represents the id of the node to be added
+     * @param longitude Represents the longitude of the node to be added. Default is 0
+     * @param latitude Represents the latitude of the node to be added. Default is 0
+     * @return True if the node with those values does not exist in the NodeSet, false otherwise.
+     * @note Time-complexity -> O(1) on average if the nodes are indexed, O(V) otherwise with V being the size of the NodeSet
+     */
+    bool addNode(const int &id, double longitude = 0, double latitude=0);
+    /**
+     * Returns the number of nodes in the (this) graph.
+     * @return The size of the NodeSet
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] int getNumNode() const;
+    /**
+     * Returns the vector NodeSet of the (this) graph.
+     * @return vector with the nodes belonging to the (this) graph
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] vector<Node *> getNodeSet() const;
+    /**
+     * Sorts the nodes of the (this) graph from lowest to highest
+     * @note Time-complexity -> O(n*log(n))
+     */
+    void sortNodes();
+    /**
+     * Sorts the edges of the (this) graph from lowest to highest
+     * @note Time-complexity -> O(n*log(n))
+     */
+    void sortEdges();
+    /**
+     * Adds an edge to the (this) graph, with origin, destination and weight passed as parameters.
+     * @param sourc Represents the origin of the edge
+     * @param dest Represents the destination of the edge
+     * @param w Represents the weight of the edge
+     * @return True if an edge with that information doesn't exist in the NodeSet, false otherwise.
+     * @note Time-complexity -> O(V) with V being the size of the NodeSet
+     *
+     */
+    bool addEdge(const int &sourc, const int &dest, double w);
+    /**
+     * Adds a bidirectional edge to the (this) graph, with origin, destination and weight passed as parameters.
+     * @param sourc Represents one of the nodes of the edge
+     * @param dest Represents one of the nodes of the edge
+     * @param w Represents the weight of the edge
+     * @return True if an edge with that information doesn't exist in the NodeSet, false otherwise.
+     * @note Time-complexity -> O(V) with V being the size of the NodeSet
+     */
+    bool addBidirectionalEdge(const int &sourc, const int &dest, double w);
+    /**
+     * Adds a node to the NodeSet without looking for another one with the same id, for bulk readers (see GraphIngest)
+     * that already know the id is new.
+     * @param id Represents the id of the node to be added, which must not be in the NodeSet
+     * @return The node added
+     * @note Time-complexity -> O(1) amortized
+     */
+    Node* addNodeUnchecked(int id, double longitude = 0, double latitude = 0);
+    /**
+     * Adds a bidirectional edge between two nodes of the (this) graph, without looking them up by id.
+     * @param sourc Represents one of the nodes of the edge
+     * @param dest Represents the other node of the edge
+     * @param w Represents the weight of the edge
+     * @note Time-complexity -> O(1) amortized
+     */
+    void addBidirectionalEdge(Node* sourc, Node* dest, double w);
+    /**
+     * Removes the node with the id given as parameter from the (this) graph, together with its outgoing and incoming edges.
+     * The incoming edges are the reverses of its outgoing ones, unless an edge was added by addEdge alone, in which case
+     * every adjacency is looked at. Note that after a removal the ids of the nodes no longer match their positions in the
+     * NodeSet, which tspBT relies on. The memory of the node and of its edges is only given back by cleanGraph.
+     * @param id Represents the id of the node to be removed
+     * @return True if the node existed, false otherwise.
+     * @note Time-complexity -> O(D*D' + V) with D being the degree of the node, D' the degree of its neighbours and V the
+     * size of the NodeSet, which is only searched for the pointer and shifted (plus O(V) to find the node if the nodes are
+     * not indexed, and O(V+E) if an edge was added by addEdge alone)
+     */
+    bool removeNode(const int &id);
+    /**
+     * Deletes the nodes and edges of the (this) graph. Nodes and edges live in slabs owned by the graph, so their memory
+     * is given back a few large blocks at a time; the nodes still have their destructors run, to free their adjacency vectors.
+     * @note Time-complexity -> O(V+B) with V being the size of the NodeSet and B the number of blocks of the slabs
+     */
+    void cleanGraph();
+    /**
+     * Appends the nodes and edges of the (this) graph to a buffer, for an ArtifactCache: the nodes in the order of the
+     * NodeSet, then the edges of each node in the order of its adjacency, with the position of their reverse edge.
+     * @param out Represents the buffer the graph is appended to
+     * @note Time-complexity -> O(V+E) with V being the size of the NodeSet and E the number of edges
+     */
+    void serialize(std::string& out) const;
+    /**
+     * Rebuilds a graph written by serialize, with the nodes, the adjacency order and the reverse edges exactly as they
+     * were, without parsing nor sorting. The coordinates and weights are taken as they are, already rounded to the storage
+     * mode of the graph that was serialized, so the graph must have been set to the same mode.
+     * @param in Represents the buffer written by serialize
+     * @return True if the buffer was valid, false otherwise (the graph is then left empty)
+     * @note Time-complexity -> O(V+E) with V being the number of nodes and E the number of edges
+     */
+    bool deserialize(const std::string& in);
+    /**
+    * Calculates the distances missing to turn a toy graph into a fully connected graph. Bases the calculations on the triangular inequality property, the sum of the lengths of any two sides must be greater than or equal to the length of the remaining side.
+    * The distances are kept in a matrix read by getDistance, so the edges of the graph are left untouched; the matrix is reused until the graph changes.
+    * @note Time-complexity -> O(V^2 * U) where U is the number of nodes not fully connected, O(1) if the matrix is up to date
+    */
+    void calculateMissingToyDistances();
+    /**
+     * Calculates the shortest path between every pair of nodes into distMatrix and pathMatrix (the node before the last on
+     * each path), with a blocked parallel Floyd-Warshall if the graph is dense and a parallel Dijkstra from every node
+     * otherwise. From then on getDistance returns the shortest path length between nodes without an edge between them,
+     * which turns any connected graph into a metric one. The matrices are reused until the graph changes.
+     * @return True if the matrices are up to date, false if the graph has more than MAX_CLOSURE_NODES nodes
+     * @note Time-complexity -> O(V^3 / T) if dense, O(V * (V + E) * log(V) / T) otherwise, with T being the number of threads
+     */
+    bool calculateMetricClosure();
+    /**
+     * Checks if the matrices built by calculateMetricClosure are up to date.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool hasMetricClosure() const;
+    /**
+     * Expands the shortest path between the two nodes given as parameters through pathMatrix.
+     * @param from Represents the first node of the path
+     * @param to Represents the last node of the path
+     * @return vector with the nodes of the path, from and to included, or empty if there is no path or the matrices are
+     * not up to date
+     * @note Time-complexity -> O(P) with P being the number of nodes of the path
+     */
+    [[nodiscard]] vector<Node*> getShortestPath(Node* from, Node* to) const;
+    /**
+     * Checks if node 0 has any adjacent edge that is yet to be visited.
+     * @return False if it finds any unvisited node, true otherwise.
+     * @note Time-complexity -> O(E) with E being the number of outgoing edges from node 0
+     */
+    bool zeroHasNoEdgesLeft();
+    /**
+     * Implementation of the backtracking algorithm. Calculates the optimal path for the (this) graph and returns the weight of said path.
+     * @param path Represents the path taken
+     * @param min Represents the minimum cost of the paths travelled so far
+     * @param curCost Represents the current cost of the path taken
+     * @param i Represents the id of the node
+     * @param curPathSize Represents the current path size
+     * @param ended Checks if the end of the path has been reached
+     * @return The minimum cost of the paths travelled
+     * @note Time-complexity -> O((n-1)!*E) with n being the number of nodes in the graph
+     */
+    double tspBTRec(std::vector<Node *>& path, double min, double curCost, unsigned int i, unsigned int curPathSize, bool ended);
+    /**
+     * Fills the vector path with the size of the NodeSet and initialises it with 0's, also iterates over the
+     * NodeSet and sets every node's visited field as false. Returns the result of the tspBTRec, a.k.a the recursive function
+     * that implements the backtracking algorithm. Graphs of up to CompactBacktrack::MAX_NODES nodes are solved by a
+     * CompactBacktrack instead, which runs the same search over a packed copy of the edges and returns the same cost.
+     * @param path Is initially sent as an empty vector. At the end of the function call, represents the optimal path.
+     * @return The weight of the optimal path
+     * @note Time-complexity -> O((n-1)!*E) with n being the number of nodes in the graph
+     */
+    double tspBT(std::vector<Node *>& path);
+    /**
+     * Creates an MST by visiting the (this) graph in preOrder, starting with the node provided as parameter. Stores the sum of
+     * the edges of the MST in the weight variable passed as parameter. Iterative, with an explicit stack, so the depth of the
+     * MST is not limited by the size of the thread's stack.
+     * @tparam Distance Represents the distance policy the steps of the walk are measured with
+     * @param node Represents the first node to be visited
+     * @param mst Represents the nodes belonging to the MST
+     * @param firstIt Checks if the function is in its first iteration. True if it is, false otherwise
+     * @param weight Represents the sum of the edges of the MST
+     * @note Time-complexity -> O(E+N) with E being the outgoing edges of the node parameter and N the number of nodes in the graph
+     */
+    template<typename Distance>
+    void preOrder(Node* node,std::vector<Node*>& mst, bool firstIt, double& weight);
+    /**
+     * Implementation of the triangular approximation heuristic. Utilizes the triangular inequality law to approximate a value
+     * close to the optimal one, in return for more efficiency. With the Cluster scope the nodeSet is a cluster, solved on a
+     * Subgraph so that no node or edge of the (this) graph is modified, and the returned path is not closed.
+     * Instantiated for the three distance policies and both scopes.
+     * @tparam Distance Represents the distance policy of the type of graph (MatrixDistance, ExplicitDistance or GeographicDistance)
+     * @tparam Scope Represents if the nodeSet is the whole graph (WholeGraph) or a cluster of it (Cluster)
+     * @param nodeSet Represents the NodeSet of the (this) graph, or the cluster
+     * @param mst Represents the nodes belonging to the MST
+     * @return The weight of the path taken
+     * @note Time-complexity -> O(N*E + E*log(E)), where N is the size of the nodeSet vector and E is the number of edges in the graph. For a Cluster, O(N + E*log(E)) with E being the number of edges inside the cluster.
+     */
+    template<typename Distance, typename Scope = WholeGraph>
+    double TriangularApproximationHeuristic(vector<Node*> nodeSet, std::vector<Node*>& mst);
+    /**
+     * Runs the triangular approximation heuristic on the whole graph with the distance policy of the given type of graph,
+     * for the callers that only know the type at runtime. The type is looked at once, before the heuristic starts.
+     * @param nodeSet Represents the NodeSet of the (this) graph
+     * @param mst Represents the nodes belonging to the MST
+     * @param type Represents the type of graph: toy, real, or any other for a fully connected one
+     * @return The weight of the path taken
+     * @note Time-complexity -> The one of TriangularApproximationHeuristic
+     */
+    double TriangularApproximationHeuristic(vector<Node*> nodeSet, std::vector<Node*>& mst, const std::string& type);
+    /**
+     * Implementation of the kruskal algorithm. Creates an MST and returns the sum of the weight of the selected edges.
+     * The edges are packed into an array and solved by ParallelMST; ties between equal weights are broken by adjacency order.
+     * @return The sum of the weight of the edges of the MST
+     * @note Time-complexity -> O(E + N*log(N)*log(E/N)) expected, where N is the number of nodes and E is the number of edges
+     */
+    double kruskal();
+    /**
+     * Depth-first Search used in the implementation of the kruskal algorithm. Iterative, with an explicit stack, visiting the
+     * nodes in the same order as the recursive DFS.
+     * @param v Represents a node which edges will be used in the DFS
+     * @note Time-complexity -> O(V+E) where V and E are the number of nodes and edges reachable from the v node
+     */
+    void dfsKruskalPath(Node *v);
+    /**
+     * Implementation of the kruskal algorithm, specific to the 3rd exercise. The MST is computed on a Subgraph of the
+     * cluster and its edges are then marked as selected.
+     * @param nodeSet Represents a cluster of nodes
+     * @return The sum of the weight of the edges of the MST
+     * @note Time-complexity -> O(N + E*log(E)), where N is the number of nodes of the cluster and E is the number of their outgoing edges
+     */
+    double kruskalEx3(vector<Node*>& nodeSet);
+    /**
+     * Returns the weight of the edge between the two nodes passed as parameters.
+     * @param first Represents one of the nodes of the edge
+     * @param second Represents one of the nodes of the edge
+     * @return The weight of the edge if it exists, INF otherwise
+     * @note Time-complexity -> O(E) with E being the number of outgoing edges of the first node
+     */
+    static double getEdgeWeight(Node* first, Node* second);
+    /**
+     * Builds the index used by getDistance, with the weight of every edge of the (this) graph keyed by its endpoints.
+     * When an edge appears more than once, the lightest one is kept (the first one in the adjacency vector once the edges
+     * are sorted, as in getEdgeWeight). Once built, the index is kept up to date by addEdge, addBidirectionalEdge and removeNode.
+     * @note Time-complexity -> O(V+E) with V being the size of the NodeSet and E the number of edges
+     */
+    void indexEdges();
+    /**
+     * Builds the index used by findNode, with every node of the (this) graph keyed by its id. Once built, the index is kept
+     * up to date by addNode, addNodeUnchecked and removeNode.
+     * @note Time-complexity -> O(V) with V being the size of the NodeSet
+     */
+    void indexNodes();
+    /**
+     * Checks if the index used by findNode is up to date.
+     * @return True if indexNodes was called since the graph was last cleaned, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool isNodeIndexed() const;
+    /**
+     * Checks if the index used by getDistance is up to date.
+     * @return True if indexEdges was called since the graph was last cleaned, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool isEdgeIndexed() const;
+    /**
+     * Returns the distance between the two nodes passed as parameters: the weight of the edge between them if it exists,
+     * their shortest path length if calculateMetricClosure is up to date, the distance calculated by
+     * calculateMissingToyDistances if it is up to date, their haversine distance otherwise.
+     * Uses the index built by indexEdges when it is up to date.
+     * @param first Represents one of the nodes
+     * @param second Represents one of the nodes
+     * @return The distance between the two nodes, 0 if they are the same node
+     * @note Time-complexity -> O(1) on average if the edges are indexed, O(E) otherwise with E being the number of outgoing edges of the first node
+     */
+    [[nodiscard]] double getDistance(Node* first, Node* second) const;
+    static const std::size_t LAZY_EDGE_SLOTS = 1 << 18;     // 6 MB, set by loadDataset for the real-world graphs
+    /**
+     * Makes getDistance keep the distances it computes from coordinates (between nodes the graph has no edge between) in
+     * a LazyEdgeCache of the given number of slots, so a sparse real-world graph can be used as a complete one without
+     * adding V^2 edges to it: each missing edge is computed the first time it is needed and asking for it again is a
+     * lookup. The cache is dropped when a node is removed or the graph is cleaned.
+     * @param capacity Represents the number of slots (24 bytes each), rounded up to a power of two. 0 turns the cache off
+     * @note Time-complexity -> O(capacity)
+     */
+    void setLazyEdges(std::size_t capacity);
+    /**
+     * Returns the cache set by setLazyEdges, or nullptr if it is off.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const LazyEdgeCache* getLazyEdges() const;
+    /**
+     * Estimates the bytes taken by the (this) graph: its nodes and edges with their adjacency vectors, the node and edge
+     * indexes and the caches of distances (the metric closure, the completed toy distances and the cache of missing edges).
+     * @note Time-complexity -> O(V) with V being the size of the NodeSet
+     */
+    [[nodiscard]] std::size_t memoryBytes() const;
+    /**
+     * Returns the weight of the hamiltonian cycle given as parameter, using getDistance. The cycle is closed from the last
+     * node back to the first one unless the vector already ends with the first node. With FIXED_POINT storage the weights
+     * are summed as integers, so the result is exact.
+     * @param tour Represents the nodes of the cycle in visiting order
+     * @return The weight of the cycle
+     * @note Time-complexity -> O(n) with n being the size of the tour vector, if the edges are indexed
+     */
+    [[nodiscard]] double getTourWeight(const vector<Node*>& tour) const;
+    /**
+     * Calculates the best nodes to link two clusters with solved hamiltonian cycles and merges the two clusters. Stores the
+     * weight of the hamiltonian cycle in the variable weight passed as parameter.
+     * @param solved Represents one of the clusters to be merged
+     * @param add Represents one of the clusters to be merged
+     * @param weight Represents the weight of the hamiltonian cycle of the merged clusters
+     * @return Merged cluster of the solved and add clusters
+     * @note Time-complexity -> O(S * A + S + A) with S being the size of solved vector and A the size of the add vector
+     */
+    static vector<Node*> joinSolvedTSP(std::vector<Node*> solved, std::vector<Node*> add, double& weight);
+    /**
+     * Creates clusters with a centroid in the center of each cluster.
+     * @param centroids Represents the centroids created randomly
+     * @param cluster Represents the cluster in which the clusters will be created
+     * @note Time-complexity -> O(C + K * C) with C being the size of the cluster vector and K the size of the centroids vector
+     */
+    static void makeClusters(const std::vector<Node*>&centroids, vector<Node*>& cluster);
+    /**
+     * Returns the cluster of a centroid
+     * @param centroid Represents the centroid of a cluster
+     * @param cluster Represents a cluster of nodes
+     * @return vector&lt Node*> with every node pertaining to the cluster of a centroid
+     * @note Time-complexity -> O(n) with n being the size of the cluster vector
+     */
+    static vector<Node*> getCentroidCluster(Node* centroid, vector<Node*> const& cluster);
+    /**
+     * Checks if the nodes of a cluster have similar distance by analysing the mean and standard deviation of their distances.
+     * @param cluster Represents a cluster of nodes
+     * @return True if the standard deviation is less or equal than 10% of the mean of the nodes' distances
+     * @note Time-complexity -> O(1)
+     */
+    static bool haveSimilarDistance(const vector<Node*>& cluster);
+    /**
+     * Implementation of the k-means algorithm using a divide and conquer approach.
+     * @param k Represents the number of clusters created in each iteration of this algorithm
+     * @param clusters Represents the current cluster of nodes
+     * @param totalMin Represents the total weight of the path of the clusters variable
+     * @param firstIt Checks if the function is in its first iteration. True if it is, false otherwise
+     * @param seed Represents the seed of the random centroids, so that a run can be repeated. If 0, the current time is used
+     * @return The path solved by the approximation heuristic
+     * @note Time-complexity -> O((C + K * C) * log(K)) with C being the size of the clusters vector and K the size of the centroids vector
+     */
+    vector<Node*> kMeansDivideAndConquer(int k, std::vector<Node*> clusters, double& totalMin, bool firstIt, unsigned int seed = 0);
+protected:
+    /**
+     * Recursive step of kMeansDivideAndConquer. Sibling clusters are disjoint and each one only writes the auxiliary
+     * fields (visited, path, dist, clusterID, selected) of its own nodes and of their outgoing edges, so they are
+     * solved concurrently on the shared ThreadPool and then joined in the order of their centroids.
+     * @param k Represents the number of clusters created in this call
+     * @param clusters Represents the current cluster of nodes
+     * @param totalMin Represents the total weight of the path of the clusters variable
+     * @param firstIt Checks if the function is in its first iteration. True if it is, false otherwise
+     * @param seed Represents the seed of the random centroids of this call. The seeds of the sub-clusters are drawn from it
+     * @param depth Represents the depth of this call in the recursion, for the stats
+     * @return The path solved by the approximation heuristic
+     * @note Time-complexity -> O((C + K * C) * log(K)) with C being the size of the clusters vector and K the size of the centroids vector
+     */
+    vector<Node*> kMeansRec(int k, std::vector<Node*> clusters, double& totalMin, bool firstIt, unsigned int seed, unsigned int depth = 0);
+
+    std::vector<Node *> NodeSet;    // Node set
+    Slab<Node> nodeSlab;            // memory of the nodes of the NodeSet
+    Slab<Edge> edgeSlab;            // memory of the edges of those nodes
+
+    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
+    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
+    std::vector<Node*> closureNodes;                        // node of each row of the matrices
+    std::unordered_map<int, unsigned int> closurePosition;  // row of each node id in the matrices
+    bool closureValid = false;
+    static const unsigned int MAX_CLOSURE_NODES = 5000;     // the matrices take 12*V^2 bytes
+
+    std::unordered_map<int, Node*> nodeIndex;   // nodes by id, built by indexNodes
+    bool nodeIndexValid = false;
+    std::size_t oneWayEdges = 0;    // edges added without a reverse, which removeNode can only find by their origin
+
+    Precision precision;            // how weights and coordinates are stored, set by setStorage
+    EdgeIndex edgeIndex;            // edge weights by (orig id, dest id), built by indexEdges
+    bool edgeIndexValid = false;
+    std::unique_ptr<LazyEdgeCache> lazyEdges;     // missing edges computed by getDistance, if set by setLazyEdges
+
+    std::vector<double> toyDistances;                   // completed distances of a toy graph, built by calculateMissingToyDistances
+    std::unordered_map<int, unsigned int> toyPosition;  // row of each node id in toyDistances
+    bool toyDistancesValid = false;
+
+    /**
+     * Marks the toy distances and the metric closure as out of date, after the nodes or edges of the graph change.
+     * @note Time-complexity -> O(1)
+     */
+    void invalidateDistances();
+
+    /**
+     * Adds the edge given by its endpoints and weight to the edge index, keeping the lighter weight if it is already there.
+     * @note Time-complexity -> O(1) on average
+     */
+    void indexEdge(int orig, int dest, double w);
+};
+
+void deleteMatrix(int **m, int n);
+void deleteMatrix(double **m, int n);
+
+#endif /* DA_TP_CLASSES_GRAPH */
@@ -0,0 +1,88 @@
+#include "GraphIngest.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+IngestStats& IngestStats::operator+=(const IngestStats& other) {
+    rows += other.rows;
+    edges += other.edges;
+    duplicates += other.duplicates;
+    selfLoops += other.selfLoops;
+    unknownNodes += other.unknownNodes;
+    malformed += other.malformed;
+    nodes += other.nodes;
+    duplicateNodes += other.duplicateNodes;
+    return *this;
+}
+
+GraphIngest::GraphIngest(Graph& graph, bool addMissingNodes): graph(graph), addMissingNodes(addMissingNodes) {}
+
+void GraphIngest::addNode(int id, double longitude, double latitude) {
+    nodes.emplace_back(id, longitude, latitude);
+}
+
+void GraphIngest::addEdge(int sourc, int dest, double w) {
+    rows.push_back({sourc, dest, w});
+    stats.rows++;
+}
+
+void GraphIngest::addMalformed() {
+    stats.malformed++;
+}
+
+IngestStats GraphIngest::commit() {
+    std::unordered_map<int, Node*> byId;
+    byId.reserve(graph.getNumNode() + nodes.size());
+    for (Node* node : graph.getNodeSet()) byId.emplace(node->getId(), node);
+    for (auto& [id, longitude, latitude] : nodes) {
+        if (byId.count(id)) {
+            stats.duplicateNodes++;
+            continue;
+        }
+        byId.emplace(id, graph.addNodeUnchecked(id, longitude, latitude));
+        stats.nodes++;
+    }
+    auto find = [&](int id) -> Node* {
+        auto it = byId.find(id);
+        if (it != byId.end()) return it->second;
+        if (!addMissingNodes) return nullptr;
+        stats.nodes++;
+        return byId.emplace(id, graph.addNodeUnchecked(id)).first->second;
+    };
+
+    struct Candidate {
+        uint64_t key;       // the ids of the endpoints, lowest first, so both directions of an edge match
+        double w;
+        unsigned int order; // row of the candidate
+        Node* sourc;
+        Node* dest;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(rows.size());
+    for (unsigned int i = 0; i < rows.size(); i++) {
+        Node* sourc = find(rows[i].sourc);
+        Node* dest = find(rows[i].dest);
+        if (sourc == nullptr || dest == nullptr) stats.unknownNodes++;
+        else if (sourc == dest) stats.selfLoops++;
+        else {
+            int low = std::min(rows[i].sourc, rows[i].dest), high = std::max(rows[i].sourc, rows[i].dest);
+            candidates.push_back({((uint64_t) (uint32_t) low << 32) | (uint32_t) high, rows[i].w, i, sourc, dest});
+        }
+    }
+    // the lightest row of each edge, the first one among equally light rows, then back in the order of the rows
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return std::tie(a.key, a.w, a.order) < std::tie(b.key, b.w, b.order);
+    });
+    auto last = std::unique(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.key == b.key; });
+    stats.duplicates += candidates.end() - last;
+    candidates.erase(last, candidates.end());
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.order < b.order; });
+    for (const Candidate& candidate : candidates) graph.addBidirectionalEdge(candidate.sourc, candidate.dest, candidate.w);
+    stats.edges += candidates.size();
+
+    IngestStats result = stats;
+    stats = IngestStats();
+    nodes.clear();
+    rows.clear();
+    return result;
+}
@@ -0,0 +1,77 @@
+#ifndef PROJETO_DA_2_GRAPHINGEST_H
+#define PROJETO_DA_2_GRAPHINGEST_H
+
+#include <tuple>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * What a GraphIngest did with the rows it was given.
+ */
+struct IngestStats {
+    unsigned long rows = 0;             // edge rows given
+    unsigned long edges = 0;            // undirected edges added
+    unsigned long duplicates = 0;       // rows dropped for repeating an edge, in either direction (the lightest is kept)
+    unsigned long selfLoops = 0;        // rows dropped for joining a node to itself
+    unsigned long unknownNodes = 0;     // rows dropped for naming a node that does not exist
+    unsigned long malformed = 0;        // rows dropped because they could not be parsed
+    unsigned long nodes = 0;            // nodes added
+    unsigned long duplicateNodes = 0;   // node rows dropped for repeating an id (the first is kept)
+
+    [[nodiscard]] unsigned long dropped() const { return duplicates + selfLoops + unknownNodes + malformed; }
+    IngestStats& operator+=(const IngestStats& other);
+};
+
+/**
+ * Bulk path from the rows of a dataset to a graph. The nodes and undirected edges are collected first and added all at
+ * once by commit, which looks the ids up in a hash table built once (instead of a scan of the NodeSet per row) and drops
+ * the rows that would only grow the edge set every solver scans: self-loops, rows naming unknown nodes, and repeats of
+ * an edge already given (in either direction), of which only the lightest is kept. The edges kept are added in the
+ * order of their rows, so the graph is the one the rows would have built one by one, minus the dropped edges.
+ */
+class GraphIngest {
+public:
+    /**
+     * Constructor of the GraphIngest class.
+     * @param graph Represents the graph the rows are added to
+     * @param addMissingNodes Represents if the endpoints of the edges that are not nodes yet are added as nodes (at
+     * coordinates 0, in the order they are first named), as the toy and extra readers do, instead of dropping the row
+     * @note Time-complexity -> O(1)
+     */
+    explicit GraphIngest(Graph& graph, bool addMissingNodes = false);
+    /**
+     * Queues a node.
+     * @note Time-complexity -> O(1) amortized
+     */
+    void addNode(int id, double longitude = 0, double latitude = 0);
+    /**
+     * Queues an undirected edge.
+     * @note Time-complexity -> O(1) amortized
+     */
+    void addEdge(int sourc, int dest, double w);
+    /**
+     * Counts a row that could not be parsed.
+     * @note Time-complexity -> O(1)
+     */
+    void addMalformed();
+    /**
+     * Adds the queued nodes and edges to the graph. Edges already in the graph before are not checked for repeats.
+     * @return The stats of the rows queued since the last commit
+     * @note Time-complexity -> O(V + E*log(E)) with V being the number of nodes and E the number of queued edges
+     */
+    IngestStats commit();
+
+private:
+    struct Row {
+        int sourc, dest;
+        double w;
+    };
+
+    Graph& graph;
+    bool addMissingNodes;
+    std::vector<std::tuple<int, double, double>> nodes;
+    std::vector<Row> rows;
+    IngestStats stats;
+};
+
+#endif //PROJETO_DA_2_GRAPHINGEST_H
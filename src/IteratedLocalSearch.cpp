@@ -0,0 +1,243 @@
+#include "IteratedLocalSearch.h"
+#include <cstring>
+#include "KdTree.h"
+#include "Stats.h"
+
+static const unsigned int CANDIDATES = 8;
+static const unsigned int MAX_KICK_SEGMENT = 50;
+static const unsigned int MAX_OR_OPT_SEGMENT = 3;
+static const unsigned long long WORKER_BITS = 8;
+static const unsigned long long NO_WORKER = (1 << WORKER_BITS) - 1;
+static const double EPSILON = 1e-9;
+
+static unsigned long long pack(double weight, unsigned long long worker) {
+    unsigned long long bits;
+    std::memcpy(&bits, &weight, sizeof(bits));
+    return (bits & ~NO_WORKER) | worker;
+}
+
+IteratedLocalSearch::IteratedLocalSearch(Graph& graph, const vector<Node*>& tour, const CandidateSet* candidateSet, ThreadPool& pool):
+        graph(graph), pool(pool), nodes(tour), best(graph, tour, false) {
+    if (nodes.size() > 1 && nodes.front() == nodes.back()) nodes.pop_back();
+    if (!graph.isEdgeIndexed()) graph.indexEdges();
+    unsigned int n = nodes.size();
+
+    unordered_map<const Node*, unsigned int> local;
+    for (unsigned int i = 0; i < n; i++) local.emplace(nodes[i], i);
+    candidates.assign(n, {});
+    if (candidateSet != nullptr && !candidateSet->empty()) {
+        const vector<Node*>& setNodes = candidateSet->getNodes();
+        for (unsigned int s = 0; s < setNodes.size(); s++) {
+            auto it = local.find(setNodes[s]);
+            if (it == local.end()) continue;
+            for (unsigned int c : candidateSet->of(s)) {
+                auto other = local.find(setNodes[c]);
+                if (other != local.end() && candidates[it->second].size() < CANDIDATES) candidates[it->second].push_back(other->second);
+            }
+        }
+    } else {
+        KdTree tree(nodes, graph.getPrecision().getStorage());
+        unsigned int tasks = std::min(pool.size() + 1, std::max(1u, n));
+        pool.parallelFor(tasks, [&](unsigned int t) {
+            vector<pair<double, unsigned int>> found;
+            for (unsigned int i = t; i < n; i += tasks) {
+                found.clear();
+                for (unsigned int j : tree.nearest(nodes[i]->getLon(), nodes[i]->getLat(), CANDIDATES + 1)) {
+                    if (j != i) found.emplace_back(dist(i, j), j);
+                }
+                for (Edge* edge : nodes[i]->getAdj()) {
+                    auto it = local.find(edge->getDest());
+                    if (it != local.end() && it->second != i) found.emplace_back(dist(i, it->second), it->second);
+                }
+                std::sort(found.begin(), found.end());
+                for (unsigned int c = 0; c < found.size() && candidates[i].size() < CANDIDATES; c++) {
+                    if (c == 0 || found[c].second != found[c - 1].second) candidates[i].push_back(found[c].second);
+                }
+            }
+        });
+    }
+
+    weight = graph.getTourWeight(nodes);
+    history = {{0, weight}};
+}
+
+vector<Node*> IteratedLocalSearch::getTour() const {
+    return best.toVector();
+}
+
+double IteratedLocalSearch::getWeight() const {
+    return weight;
+}
+
+const vector<pair<double, double>>& IteratedLocalSearch::getHistory() const {
+    return history;
+}
+
+double IteratedLocalSearch::dist(unsigned int a, unsigned int b) const {
+    return graph.getDistance(nodes[a], nodes[b]);
+}
+
+double IteratedLocalSearch::run(unsigned int workers, double seconds, unsigned int seed) {
+    history = {{0, weight}};
+    if (nodes.size() < 8) return weight;
+    STATS_PHASE("ils");
+    workers = std::max(1u, std::min({workers, pool.size() + 1, (unsigned int) NO_WORKER}));
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+
+    incumbent = pack(best.getCost(), NO_WORKER);
+    workerBest.assign(workers, best);
+    workerHistory.assign(workers, {});
+    mt19937 rng(seed);
+    vector<unsigned int> seeds(workers);
+    for (unsigned int& s : seeds) s = rng();
+    pool.parallelFor(workers, [&](unsigned int w) { work(w, seeds[w], start, deadline); });
+
+    unsigned long long owner = incumbent.load() & NO_WORKER;
+    if (owner != NO_WORKER) best = workerBest[owner];
+    weight = graph.getTourWeight(best.toVector());  // drops the rounding errors of the deltas
+
+    vector<pair<double, double>> improvements;
+    for (auto& worker : workerHistory) improvements.insert(improvements.end(), worker.begin(), worker.end());
+    std::sort(improvements.begin(), improvements.end());
+    for (auto& improvement : improvements) {
+        if (improvement.second < history.back().second) history.push_back(improvement);
+    }
+    workerBest.clear();
+    workerHistory.clear();
+    return weight;
+}
+
+void IteratedLocalSearch::work(unsigned int worker, unsigned int seed, std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::time_point deadline) {
+    unsigned int n = nodes.size();
+    mt19937 rng(seed);
+    Tour cur = best;
+    vector<unsigned int> queue(n);
+    vector<bool> queued(n, true);
+    for (unsigned int i = 0; i < n; i++) queue[i] = n - 1 - i;
+
+    auto publish = [&](double weight) {
+        unsigned long long mine = pack(weight, worker), old = incumbent.load();
+        while (mine < old && !incumbent.compare_exchange_weak(old, mine)) {}
+        if (mine < old) {
+            workerHistory[worker].emplace_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), weight);
+        }
+    };
+
+    Tour& saved = workerBest[worker];
+    localSearch(cur, queue, queued, deadline);
+    saved = cur;
+    publish(saved.getCost());
+
+    unsigned int maxSegment = std::min(MAX_KICK_SEGMENT, (n - 2) / 2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        // double bridge: a B C d -> a C B d, with B and C short consecutive segments, as three reversals:
+        // a C' B' d, then a C B' d, then a C B d
+        unsigned int a = rng() % n, lenB = 1 + rng() % maxSegment, lenC = 1 + rng() % maxSegment;
+        unsigned int b1 = cur.nextIndex(a), bL = b1;
+        for (unsigned int k = 1; k < lenB; k++) bL = cur.nextIndex(bL);
+        unsigned int c1 = cur.nextIndex(bL), cL = c1;
+        for (unsigned int k = 1; k < lenC; k++) cL = cur.nextIndex(cL);
+        unsigned int d = cur.nextIndex(cL);
+        cur.reverseIndex(b1, cL);
+        cur.reverseIndex(a, cL, c1);
+        cur.reverseIndex(d, b1, bL);
+        for (unsigned int touched : {a, b1, bL, c1, cL, d}) {
+            if (!queued[touched]) {
+                queued[touched] = true;
+                queue.push_back(touched);
+            }
+        }
+
+        localSearch(cur, queue, queued, deadline);
+        if (cur.getCost() < saved.getCost() - EPSILON) {
+            saved = cur;
+            publish(saved.getCost());
+        } else {
+            cur = saved;
+        }
+    }
+}
+
+void IteratedLocalSearch::localSearch(Tour& tour, vector<unsigned int>& queue, vector<bool>& queued,
+                                      std::chrono::steady_clock::time_point deadline) const {
+    vector<unsigned int> touched;
+    for (unsigned int steps = 0; !queue.empty(); steps++) {
+        if (steps % 256 == 255 && std::chrono::steady_clock::now() >= deadline) break;
+        unsigned int a = queue.back();
+        queue.pop_back();
+        queued[a] = false;
+        touched.clear();
+        if (!improve(tour, a, touched)) continue;
+        for (unsigned int t : touched) {
+            if (!queued[t]) {
+                queued[t] = true;
+                queue.push_back(t);
+            }
+        }
+    }
+    for (unsigned int q : queue) queued[q] = false;
+    queue.clear();
+}
+
+bool IteratedLocalSearch::improve(Tour& tour, unsigned int a, vector<unsigned int>& touched) const {
+    unsigned int n = tour.size();
+    auto succ = [&](unsigned int v) { return tour.nextIndex(v); };
+    auto pred = [&](unsigned int v) { return tour.prevIndex(v); };
+
+    // 2-opt: (a, succ a) and (c, succ c) become (a, c) and (succ a, succ c), or the same with the predecessors
+    for (int direction = 0; direction < 2; direction++) {
+        unsigned int b = direction == 0 ? succ(a) : pred(a);
+        double removed = dist(a, b);
+        for (unsigned int c : candidates[a]) {
+            double added = dist(a, c);
+            if (added >= removed) break;
+            unsigned int d = direction == 0 ? succ(c) : pred(c);
+            if (c == b || d == a) continue;
+            double delta = added + dist(b, d) - removed - dist(c, d);
+            if (delta < -EPSILON) {
+                if (direction == 0) tour.reverseIndex(b, c);
+                else tour.reverseIndex(a, d);
+                touched = {a, b, c, d};
+                return true;
+            }
+        }
+    }
+
+    // or-opt: move the segment of 1 to 3 nodes starting at a between two other neighbouring nodes, in either orientation
+    unsigned int segment[MAX_OR_OPT_SEGMENT] = {a};
+    for (unsigned int len = 1; len <= MAX_OR_OPT_SEGMENT && len + 3 <= n; len++) {
+        if (len > 1) segment[len - 1] = succ(segment[len - 2]);
+        unsigned int s1 = a, s2 = segment[len - 1], p = pred(s1), nx = succ(s2);
+        auto inSegment = [&](unsigned int v) { return std::find(segment, segment + len, v) != segment + len; };
+        double removed = dist(p, s1) + dist(s2, nx) - dist(p, nx);
+        if (removed <= EPSILON) continue;
+        for (unsigned int end : {s1, s2}) {
+            for (unsigned int c : candidates[end]) {
+                if (dist(end, c) >= removed) break;
+                if (inSegment(c)) continue;
+                for (unsigned int e : {succ(c), pred(c)}) {
+                    if (inSegment(e)) continue;
+                    unsigned int u = e == succ(c) ? c : e, v = e == succ(c) ? e : c;
+                    double forward = dist(u, s1) + dist(s2, v), backward = dist(u, s2) + dist(s1, v);
+                    double delta = std::min(forward, backward) - dist(u, v) - removed;
+                    if (delta < -EPSILON) {
+                        moveSegment(tour, s1, s2, u, backward < forward);
+                        touched = {p, nx, s1, s2, u, v};
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void IteratedLocalSearch::moveSegment(Tour& tour, unsigned int s1, unsigned int s2, unsigned int u, bool reversed) {
+    // p S nx..u v -> p u..nx S' v -> p nx..u S' v, and then S' -> S if kept forward
+    unsigned int p = tour.prevIndex(s1), nx = tour.nextIndex(s2);
+    tour.reverseIndex(p, s1, u);
+    tour.reverseIndex(p, u, nx);
+    if (!reversed) tour.reverseIndex(u, s2, s1);
+}
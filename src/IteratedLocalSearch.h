@@ -0,0 +1,98 @@
+#ifndef PROJETO_DA_2_ITERATEDLOCALSEARCH_H
+#define PROJETO_DA_2_ITERATEDLOCALSEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include "CandidateSet.h"
+#include "Graph.h"
+#include "ThreadPool.h"
+#include "Tour.h"
+
+class IteratedLocalSearch {
+public:
+    /**
+     * Constructor of the IteratedLocalSearch class. Takes a tour already solved on the graph (e.g. by the Triangular
+     * Approximation Heuristic) as the starting point of every worker, and builds the candidate neighbours of each node:
+     * the closest ones among its edges and its nearest nodes by coordinates, unless a candidate set is given. Builds the
+     * edge index of the graph if it is not up to date.
+     * @param graph Represents the graph the tour was solved on
+     * @param tour Represents the starting tour, closed or not
+     * @param candidateSet Represents precomputed candidates (e.g. ALPHA ones) to use instead, if not nullptr. Only the
+     * first CANDIDATES of each node that are in the tour are kept
+     * @param pool Represents the pool the workers run on
+     * @note Time-complexity -> O(n*(K*log(n) + D)) with n being the size of the tour, K the number of candidates and D the degree of the nodes
+     */
+    IteratedLocalSearch(Graph& graph, const std::vector<Node*>& tour, const CandidateSet* candidateSet = nullptr,
+                        ThreadPool& pool = ThreadPool::shared());
+    /**
+     * Runs independent iterated local search workers until the time budget runs out. Each worker repeatedly applies a
+     * double-bridge kick (swapping two short consecutive segments) to its best tour, improves the result with 2-opt and
+     * or-opt moves over the candidate neighbours, and keeps it if it is shorter. The shortest tour of all the workers is
+     * kept in a lock-free incumbent, and every improvement of the incumbent is recorded with its time.
+     * @param workers Represents the number of workers, at most one per thread of the pool plus the calling thread
+     * @param seconds Represents the time budget
+     * @param seed Represents the seed of the kicks. The seeds of the workers are drawn from it
+     * @return The length of the best tour found
+     * @note Time-complexity -> O(seconds), each iteration costing O(n) for copying the tour plus the local search
+     */
+    double run(unsigned int workers, double seconds, unsigned int seed);
+    /**
+     * Returns the best tour found by the last call of run (or the starting tour), closed with its first node.
+     * @return vector with the nodes of the tour
+     * @note Time-complexity -> O(n) with n being the size of the tour
+     */
+    [[nodiscard]] std::vector<Node*> getTour() const;
+    /**
+     * Returns the length of the tour returned by getTour.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double getWeight() const;
+    /**
+     * Returns the improvements of the incumbent during the last call of run, as (milliseconds since the start, length)
+     * pairs in time order, starting with the length of the starting tour at 0 ms.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<std::pair<double, double>>& getHistory() const;
+
+private:
+    /**
+     * Loop of one worker, which publishes its improvements into incumbent.
+     */
+    void work(unsigned int worker, unsigned int seed, std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point deadline);
+    /**
+     * Applies improving 2-opt and or-opt moves around the nodes in queue (and around the nodes they touch) until none is
+     * left or the deadline passes, and empties the queue.
+     * @note Time-complexity -> O(M * K * n) in the worst case, with M being the number of moves and K the number of candidates
+     */
+    void localSearch(Tour& tour, std::vector<unsigned int>& queue, std::vector<bool>& queued,
+                     std::chrono::steady_clock::time_point deadline) const;
+    /**
+     * Tries the 2-opt and or-opt moves that start at node a, and applies the first improving one.
+     * @return True if a move was applied, false otherwise
+     */
+    bool improve(Tour& tour, unsigned int a, std::vector<unsigned int>& touched) const;
+    /**
+     * Moves the path from s1 forward to s2 to right after the node u, reversed if asked to, with three reversals: the
+     * path from s1 to u, then the part that went from s2 to u, then the moved path if kept forward.
+     */
+    static void moveSegment(Tour& tour, unsigned int s1, unsigned int s2, unsigned int u, bool reversed);
+    [[nodiscard]] double dist(unsigned int a, unsigned int b) const;
+
+    Graph& graph;
+    ThreadPool& pool;
+    std::vector<Node*> nodes;
+    std::vector<std::vector<unsigned int>> candidates;   // closest nodes of each node, closest first
+    Tour best;      // over the indices of nodes; an array at any size, since every kick copies it
+    double weight;  // length of best, summed again at the end of every run
+    std::vector<std::pair<double, double>> history;
+
+    // best length found so far, with the index of the worker holding it in the lowest bits (positive doubles keep their
+    // order when compared as integers), so a single CAS publishes both
+    std::atomic<unsigned long long> incumbent{0};
+    std::vector<Tour> workerBest;
+    std::vector<std::vector<std::pair<double, double>>> workerHistory;
+};
+
+#endif //PROJETO_DA_2_ITERATEDLOCALSEARCH_H
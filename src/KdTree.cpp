@@ -0,0 +1,123 @@
+#include "KdTree.h"
+#include "calculations.h"
+#include <type_traits>
+
+static const double FIXED_UNITS = 1 << 29;     // fixed-point units per radius of the unit sphere
+
+static void toUnitSphere(double lon, double lat, double* coords) {
+    double radLon = convertToRadians(lon), radLat = convertToRadians(lat);
+    coords[0] = cos(radLat) * cos(radLon);
+    coords[1] = cos(radLat) * sin(radLon);
+    coords[2] = sin(radLat);
+}
+
+/**
+ * Returns the coordinate c of the unit sphere in the coordinate type T of the points.
+ */
+template <typename T>
+static T toStored(double c) {
+    if constexpr (std::is_integral_v<T>) return (T) std::lround(c * FIXED_UNITS);
+    else return (T) c;
+}
+
+/**
+ * Type the squared distances between points of coordinate type T are computed in: exact 64-bit integers for fixed-point
+ * points (3 * (2^30)^2 < 2^63), doubles otherwise.
+ */
+template <typename T>
+using DistanceOf = std::conditional_t<std::is_integral_v<T>, int64_t, double>;
+
+KdTree::KdTree(const std::vector<Node*>& nodes, Storage storage): storage(storage) {
+    switch (storage) {
+        case Storage::FLOAT32: fill(floatPoints, nodes); break;
+        case Storage::FIXED_POINT: fill(fixedPoints, nodes); break;
+        default: fill(doublePoints, nodes);
+    }
+}
+
+unsigned int KdTree::size() const {
+    return doublePoints.size() + floatPoints.size() + fixedPoints.size();
+}
+
+std::size_t KdTree::memoryBytes() const {
+    return doublePoints.capacity() * sizeof(Point<double>) + floatPoints.capacity() * sizeof(Point<float>)
+           + fixedPoints.capacity() * sizeof(Point<int32_t>);
+}
+
+template <typename T>
+void KdTree::fill(std::vector<Point<T>>& points, const std::vector<Node*>& nodes) {
+    points.resize(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        double coords[3];
+        toUnitSphere(nodes[i]->getLon(), nodes[i]->getLat(), coords);
+        for (int d = 0; d < 3; d++) points[i].coords[d] = toStored<T>(coords[d]);
+        points[i].index = i;
+    }
+    build(points, 0, points.size(), 0);
+}
+
+template <typename T>
+void KdTree::build(std::vector<Point<T>>& points, unsigned int lo, unsigned int hi, unsigned int depth) {
+    if (hi - lo <= 1) return;
+    unsigned int axis = depth % 3, mid = lo + (hi - lo) / 2;
+    std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi, [axis](const Point<T>& a, const Point<T>& b) {
+        return a.coords[axis] < b.coords[axis];
+    });
+    build(points, lo, mid, depth + 1);
+    build(points, mid + 1, hi, depth + 1);
+}
+
+template <typename T, typename D>
+void KdTree::search(const std::vector<Point<T>>& points, unsigned int lo, unsigned int hi, unsigned int depth,
+                    const D* query, unsigned int k, std::vector<std::pair<D, unsigned int>>& heap) {
+    if (lo >= hi) return;
+    unsigned int axis = depth % 3, mid = lo + (hi - lo) / 2;
+    const Point<T>& point = points[mid];
+
+    D dist = 0;
+    for (int d = 0; d < 3; d++) dist += ((D) point.coords[d] - query[d]) * ((D) point.coords[d] - query[d]);
+    if (heap.size() < k) {
+        heap.emplace_back(dist, point.index);
+        std::push_heap(heap.begin(), heap.end());
+    } else if (dist < heap.front().first) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = {dist, point.index};
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    D delta = query[axis] - (D) point.coords[axis];
+    bool left = delta < 0;
+    if (left) search(points, lo, mid, depth + 1, query, k, heap);
+    else search(points, mid + 1, hi, depth + 1, query, k, heap);
+    if (heap.size() < k || delta * delta < heap.front().first) {
+        if (left) search(points, mid + 1, hi, depth + 1, query, k, heap);
+        else search(points, lo, mid, depth + 1, query, k, heap);
+    }
+}
+
+template <typename T>
+std::vector<unsigned int> KdTree::nearest(const std::vector<Point<T>>& points, double lon, double lat, unsigned int k) {
+    using D = DistanceOf<T>;
+    std::vector<std::pair<D, unsigned int>> heap;
+    if (k == 0) return {};
+    heap.reserve(k);
+    double coords[3];
+    toUnitSphere(lon, lat, coords);
+    D query[3];
+    for (int d = 0; d < 3; d++) query[d] = toStored<T>(coords[d]);
+    search(points, 0, points.size(), 0, query, k, heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    std::vector<unsigned int> result;
+    result.reserve(heap.size());
+    for (auto& entry : heap) result.push_back(entry.second);
+    return result;
+}
+
+std::vector<unsigned int> KdTree::nearest(double lon, double lat, unsigned int k) const {
+    switch (storage) {
+        case Storage::FLOAT32: return nearest(floatPoints, lon, lat, k);
+        case Storage::FIXED_POINT: return nearest(fixedPoints, lon, lat, k);
+        default: return nearest(doublePoints, lon, lat, k);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef PROJETO_DA_2_KDTREE_H
+#define PROJETO_DA_2_KDTREE_H
+
+#include <vector>
+#include "NodeEdge.h"
+#include "Precision.h"
+
+class KdTree {
+public:
+    /**
+     * Constructor of the KdTree class. Builds a balanced 3-d tree over the nodes given as parameter, with each node
+     * placed on the unit sphere from its longitude and latitude, so that the straight-line distance between two points
+     * grows with their haversine distance. The points are kept in the storage mode given as parameter: 32 bytes each as
+     * doubles, 16 bytes as floats (a position error of at most 2^-24 of the radius, about 0.4 m on the earth) or as 32-bit
+     * fixed-point integers with 2^29 units per radius (at most 1.2 cm), whose distances are compared exactly as integers.
+     * Nodes closer to the location than that error may then come out in another order.
+     * @param nodes Represents the nodes to be indexed. The indexes returned by the queries refer to this vector
+     * @param storage Represents the storage mode of the points, usually the one of the graph. Default is DOUBLE
+     * @note Time-complexity -> O(n*log(n)) with n being the size of the nodes vector
+     */
+    explicit KdTree(const std::vector<Node*>& nodes, Storage storage = Storage::DOUBLE);
+    /**
+     * Returns the k indexed nodes closest to the given location, closest first.
+     * @param lon Represents the longitude of the location
+     * @param lat Represents the latitude of the location
+     * @param k Represents the number of nodes to return
+     * @return vector with the positions, in the vector used to build the tree, of the closest nodes
+     * @note Time-complexity -> O(k*log(n)) on average with n being the number of indexed nodes
+     */
+    [[nodiscard]] std::vector<unsigned int> nearest(double lon, double lat, unsigned int k) const;
+    /**
+     * Returns the number of indexed nodes.
+     * @return The number of indexed nodes
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int size() const;
+    /**
+     * Returns the number of bytes taken by the points of the tree.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t memoryBytes() const;
+private:
+    template <typename T>
+    struct Point {
+        T coords[3];
+        unsigned int index;
+    };
+    /**
+     * Places the nodes on the unit sphere in points, rounded to the coordinate type T, and builds the tree over them.
+     * @note Time-complexity -> O(n*log(n)) with n being the size of the nodes vector
+     */
+    template <typename T>
+    static void fill(std::vector<Point<T>>& points, const std::vector<Node*>& nodes);
+    /**
+     * Places the median of points[lo, hi) along the axis of the given depth in the middle of the range and builds both halves.
+     * @note Time-complexity -> O(m*log(m)) with m being hi - lo
+     */
+    template <typename T>
+    static void build(std::vector<Point<T>>& points, unsigned int lo, unsigned int hi, unsigned int depth);
+    /**
+     * Visits the subtree points[lo, hi), keeping in heap the k closest points to query found so far, with the squared
+     * distances computed in D (doubles, or 64-bit integers for fixed-point points).
+     * @note Time-complexity -> O(k*log(m)) on average with m being hi - lo
+     */
+    template <typename T, typename D>
+    static void search(const std::vector<Point<T>>& points, unsigned int lo, unsigned int hi, unsigned int depth,
+                       const D* query, unsigned int k, std::vector<std::pair<D, unsigned int>>& heap);
+    /**
+     * nearest over the points of coordinate type T.
+     */
+    template <typename T>
+    static std::vector<unsigned int> nearest(const std::vector<Point<T>>& points, double lon, double lat, unsigned int k);
+
+    Storage storage;
+    std::vector<Point<double>> doublePoints;    // DOUBLE
+    std::vector<Point<float>> floatPoints;      // FLOAT32
+    std::vector<Point<int32_t>> fixedPoints;    // FIXED_POINT
+};
+
+#endif //PROJETO_DA_2_KDTREE_H
@@ -0,0 +1,59 @@
+#include "LazyEdgeCache.h"
+#include <algorithm>
+
+static uint64_t edgeKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return ((uint64_t) (uint32_t) a << 32) | (uint32_t) b;
+}
+
+static std::size_t hashKey(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+LazyEdgeCache::LazyEdgeCache(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) size *= 2;
+    slots = std::make_unique<Slot[]>(size);
+    mask = size - 1;
+}
+
+bool LazyEdgeCache::find(int a, int b, double& weight) const {
+    uint64_t key = edgeKey(a, b);
+    const Slot& slot = slots[hashKey(key) & mask];
+    uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1) return false;
+    bool match = slot.key.load(std::memory_order_relaxed) == key
+                 && slot.generation.load(std::memory_order_relaxed) == generation.load(std::memory_order_relaxed);
+    double found = slot.weight.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!match || slot.sequence.load(std::memory_order_relaxed) != before) return false;
+    weight = found;
+    return true;
+}
+
+void LazyEdgeCache::insert(int a, int b, double weight) {
+    uint64_t key = edgeKey(a, b);
+    Slot& slot = slots[hashKey(key) & mask];
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) return;
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.key.store(key, std::memory_order_relaxed);
+    slot.generation.store(generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    slot.weight.store(weight, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void LazyEdgeCache::clear() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t LazyEdgeCache::capacity() const {
+    return mask + 1;
+}
+
+std::size_t LazyEdgeCache::memoryBytes() const {
+    return capacity() * sizeof(Slot);
+}
@@ -0,0 +1,66 @@
+#ifndef PROJETO_DA_2_LAZYEDGECACHE_H
+#define PROJETO_DA_2_LAZYEDGECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Bounded side store of the edges a graph does not have but whose weight was asked for, so that a sparse real-world graph
+ * can be used as if it were complete without keeping V^2 edges: a missing edge is computed the first time it is needed
+ * and kept here, never in the adjacency of its nodes. The table is direct-mapped with a fixed number of slots, so a new
+ * edge evicts whichever edge shared its slot, and it can be read and written from many threads at once without locks:
+ * each slot is guarded by a sequence number (odd while a writer fills it) that the readers check before and after
+ * reading, and a writer that finds a slot busy simply does not cache its edge.
+ */
+class LazyEdgeCache {
+public:
+    /**
+     * Constructor of the LazyEdgeCache class.
+     * @param capacity Represents the number of slots, rounded up to a power of two
+     * @note Time-complexity -> O(capacity)
+     */
+    explicit LazyEdgeCache(std::size_t capacity);
+    /**
+     * Looks up the edge between the nodes with the given ids, in either direction.
+     * @param weight Represents the variable to which the weight is written, if the edge is there
+     * @return True if the edge is there, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    bool find(int a, int b, double& weight) const;
+    /**
+     * Keeps the edge between the nodes with the given ids, in both directions, evicting the edge in its slot.
+     * @note Time-complexity -> O(1)
+     */
+    void insert(int a, int b, double weight);
+    /**
+     * Drops every edge, e.g. after the coordinates of a node changed. The slots are not touched: they are tagged with the
+     * generation they were written in, so the old ones stop matching.
+     * @note Time-complexity -> O(1)
+     */
+    void clear();
+    /**
+     * Returns the number of slots.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t capacity() const;
+    /**
+     * Returns the number of bytes taken by the slots.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t memoryBytes() const;
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uint32_t> generation{0};
+        std::atomic<uint64_t> key{0};
+        std::atomic<double> weight{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    std::atomic<uint32_t> generation{1};    // slots from older generations, and never written ones (0), are empty
+};
+
+#endif //PROJETO_DA_2_LAZYEDGECACHE_H
@@ -0,0 +1,117 @@
+#include "MetricClosure.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include "NodeEdge.h"
+
+static const unsigned int TILE = 64;
+
+MetricClosure::MetricClosure(unsigned int numNodes, const std::vector<PackedEdge>& edges, ThreadPool& pool):
+    numNodes(numNodes), offsets(numNodes + 1, 0), targets(edges.size()), weights(edges.size()), pool(pool) {
+    for (const PackedEdge& e : edges) offsets[e.u + 1]++;
+    for (unsigned int u = 0; u < numNodes; u++) offsets[u + 1] += offsets[u];
+    std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+    for (const PackedEdge& e : edges) {
+        targets[next[e.u]] = e.v;
+        weights[next[e.u]++] = e.weight;
+    }
+}
+
+bool MetricClosure::isDense() const {
+    return targets.size() * std::log2(std::max(2u, numNodes)) >= (double) numNodes * numNodes;
+}
+
+void MetricClosure::run(double** dist, int** path) {
+    if (isDense()) floydWarshall(dist, path);
+    else dijkstra(dist, path);
+}
+
+void MetricClosure::relaxTile(double** dist, int** path, unsigned int ib, unsigned int jb, unsigned int kb) const {
+    unsigned int iEnd = std::min(numNodes, ib + TILE), jEnd = std::min(numNodes, jb + TILE), kEnd = std::min(numNodes, kb + TILE);
+    for (unsigned int k = kb; k < kEnd; k++) {
+        const double* distK = dist[k];
+        const int* pathK = path[k];
+        for (unsigned int i = ib; i < iEnd; i++) {
+            double distIK = dist[i][k];
+            if (distIK == INF) continue;
+            double* distI = dist[i];
+            int* pathI = path[i];
+            for (unsigned int j = jb; j < jEnd; j++) {
+                if (distIK + distK[j] < distI[j]) {
+                    distI[j] = distIK + distK[j];
+                    pathI[j] = pathK[j];
+                }
+            }
+        }
+    }
+}
+
+void MetricClosure::floydWarshall(double** dist, int** path) {
+    for (unsigned int i = 0; i < numNodes; i++) {
+        std::fill(dist[i], dist[i] + numNodes, INF);
+        std::fill(path[i], path[i] + numNodes, -1);
+        dist[i][i] = 0;
+        for (unsigned int e = offsets[i]; e < offsets[i + 1]; e++) {
+            unsigned int j = targets[e];
+            if (j != i && weights[e] < dist[i][j]) {
+                dist[i][j] = weights[e];
+                path[i][j] = (int) i;
+            }
+        }
+    }
+
+    unsigned int tiles = (numNodes + TILE - 1) / TILE;
+    unsigned int tasks = pool.size() + 1;
+    for (unsigned int k = 0; k < tiles; k++) {
+        unsigned int kb = k * TILE;
+        relaxTile(dist, path, kb, kb, kb);
+
+        // the tiles of row k and of column k only depend on the diagonal tile
+        pool.parallelFor(std::min(tasks, 2 * tiles), [&](unsigned int t) {
+            for (unsigned int other = t; other < 2 * tiles; other += tasks) {
+                if (other % tiles == k) continue;
+                if (other < tiles) relaxTile(dist, path, kb, other * TILE, kb);
+                else relaxTile(dist, path, (other - tiles) * TILE, kb, kb);
+            }
+        });
+
+        // every other tile depends on the tile of row k above or below it and on the tile of column k beside it
+        pool.parallelFor(std::min(tasks, tiles), [&](unsigned int t) {
+            for (unsigned int i = t; i < tiles; i += tasks) {
+                if (i == k) continue;
+                for (unsigned int j = 0; j < tiles; j++) {
+                    if (j != k) relaxTile(dist, path, i * TILE, j * TILE, kb);
+                }
+            }
+        });
+    }
+}
+
+void MetricClosure::dijkstra(double** dist, int** path) {
+    unsigned int tasks = std::min(pool.size() + 1, std::max(1u, numNodes));
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        std::priority_queue<std::pair<double, unsigned int>, std::vector<std::pair<double, unsigned int>>, std::greater<>> queue;
+        for (unsigned int source = t; source < numNodes; source += tasks) {
+            double* distS = dist[source];
+            int* pathS = path[source];
+            std::fill(distS, distS + numNodes, INF);
+            std::fill(pathS, pathS + numNodes, -1);
+            distS[source] = 0;
+            queue.emplace(0, source);
+            while (!queue.empty()) {
+                auto [d, u] = queue.top();
+                queue.pop();
+                if (d > distS[u]) continue;
+                for (unsigned int e = offsets[u]; e < offsets[u + 1]; e++) {
+                    unsigned int v = targets[e];
+                    if (d + weights[e] < distS[v]) {
+                        distS[v] = d + weights[e];
+                        pathS[v] = (int) u;
+                        queue.emplace(distS[v], v);
+                    }
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,61 @@
+#ifndef PROJETO_DA_2_METRICCLOSURE_H
+#define PROJETO_DA_2_METRICCLOSURE_H
+
+#include <vector>
+#include "ThreadPool.h"
+#include "ParallelMST.h"
+
+/**
+ * All-pairs shortest paths of a weighted directed graph, written into a distance matrix and a predecessor matrix:
+ * dist[i][j] is the length of the shortest path from i to j (INF if there is none) and path[i][j] is the node before j
+ * on that path (-1 if there is none or i == j).
+ */
+class MetricClosure {
+public:
+    /**
+     * Constructor of the MetricClosure class.
+     * @param numNodes Represents the number of nodes. The endpoints of the edges must be lower than it
+     * @param edges Represents the directed edges of the graph, from u to v (the id is not used)
+     * @param pool Represents the pool the rows or the sources are spread over
+     * @note Time-complexity -> O(V + E)
+     */
+    MetricClosure(unsigned int numNodes, const std::vector<PackedEdge>& edges, ThreadPool& pool = ThreadPool::shared());
+    /**
+     * Checks if the graph is dense enough for Floyd-Warshall to be cheaper than running Dijkstra from every node,
+     * i.e. if E*log(V) >= V^2.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool isDense() const;
+    /**
+     * Fills the matrices with floydWarshall if the graph is dense and with dijkstra otherwise.
+     * @param dist Represents a V x V matrix for the distances
+     * @param path Represents a V x V matrix for the predecessors
+     * @note Time-complexity -> The one of the algorithm used
+     */
+    void run(double** dist, int** path);
+    /**
+     * Blocked Floyd-Warshall: the matrices are split in tiles of TILE x TILE, and for each diagonal tile the tile itself,
+     * then the tiles of its row and column and then all the other tiles are relaxed through it, the tiles of each of the
+     * last two steps in parallel. Every tile relaxed at once fits in cache.
+     * @note Time-complexity -> O(V^3 / T) with T being the number of threads
+     */
+    void floydWarshall(double** dist, int** path);
+    /**
+     * Runs Dijkstra, with a binary heap, from every node, the sources being spread over the pool.
+     * @note Time-complexity -> O(V * (V + E) * log(V) / T) with T being the number of threads
+     */
+    void dijkstra(double** dist, int** path);
+private:
+    /**
+     * Relaxes the tile (ib, jb) through the nodes of the tile kb: dist[i][j] = min(dist[i][j], dist[i][k] + dist[k][j]).
+     */
+    void relaxTile(double** dist, int** path, unsigned int ib, unsigned int jb, unsigned int kb) const;
+
+    unsigned int numNodes;
+    std::vector<unsigned int> offsets;  // edges of node u are in [offsets[u], offsets[u+1])
+    std::vector<unsigned int> targets;
+    std::vector<double> weights;
+    ThreadPool& pool;
+};
+
+#endif //PROJETO_DA_2_METRICCLOSURE_H
@@ -0,0 +1,110 @@
+#include "MultiVehicle.h"
+#include <cmath>
+#include <numeric>
+#include "IteratedLocalSearch.h"
+#include "Stats.h"
+
+MultiVehicle::MultiVehicle(Graph& graph, const std::string& type, unsigned int vehicles, Balance balance, ThreadPool& pool): graph(graph), pool(pool) {
+    if (type == "toy") solveRoute = &Graph::TriangularApproximationHeuristic<MatrixDistance, Cluster>;
+    else if (type == "real") solveRoute = &Graph::TriangularApproximationHeuristic<GeographicDistance, Cluster>;
+    else solveRoute = &Graph::TriangularApproximationHeuristic<ExplicitDistance, Cluster>;
+    vehicles = std::max(1u, vehicles);
+    groups.assign(vehicles, {});
+    const vector<Node*>& nodes = graph.getNodeSet();
+    if (nodes.empty()) return;
+    // a graph already completed is left untouched, so that fleets can share it
+    if (type == "toy" && !graph.hasMetricClosure()) MatrixDistance::prepare(graph);
+    depot = graph.findNode(0);
+    if (depot == nullptr) depot = nodes[0];
+
+    vector<pair<double, Node*>> swept;
+    for (Node* node : nodes) {
+        if (node != depot) swept.emplace_back(std::atan2(node->getLat() - depot->getLat(), node->getLon() - depot->getLon()), node);
+    }
+    if (swept.empty()) return;
+    std::stable_sort(swept.begin(), swept.end(), [](auto& a, auto& b) { return a.first < b.first; });
+    // start right after the widest gap, which is the wrap-around one (from the last angle back to the first) by default
+    unsigned int start = 0;
+    double widest = swept.front().first + 2 * M_PI - swept.back().first;
+    for (unsigned int i = 1; i < swept.size(); i++) {
+        if (swept[i].first - swept[i - 1].first > widest) {
+            widest = swept[i].first - swept[i - 1].first;
+            start = i;
+        }
+    }
+    std::rotate(swept.begin(), swept.begin() + start, swept.end());
+
+    vector<double> weights(swept.size(), 1);
+    if (balance == Balance::DISTANCE) {
+        for (unsigned int i = 0; i < swept.size(); i++) weights[i] = graph.getDistance(depot, swept[i].second);
+    }
+    double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    if (!(total > 0) || std::isinf(total)) {   // no usable distances, e.g. a toy graph with no edges to the depot
+        std::fill(weights.begin(), weights.end(), 1);
+        total = swept.size();
+    }
+    // each stop goes to the vehicle whose share of the total holds the middle of its own weight
+    double before = 0;
+    for (unsigned int i = 0; i < swept.size(); i++) {
+        auto v = (unsigned int) ((before + weights[i] / 2) / total * vehicles);
+        groups[std::min(v, vehicles - 1)].push_back(swept[i].second);
+        before += weights[i];
+    }
+}
+
+double MultiVehicle::run(double seconds, unsigned int seed) {
+    STATS_PHASE("fleet");
+    unsigned int vehicles = groups.size();
+    routes.assign(vehicles, {});
+    costs.assign(vehicles, 0);
+    if (depot == nullptr) return 0;
+    if (!graph.isEdgeIndexed()) graph.indexEdges();
+
+    std::mt19937 rng(seed);
+    vector<unsigned int> seeds(vehicles);
+    for (unsigned int& s : seeds) s = rng();
+    pool.parallelFor(vehicles, [&](unsigned int v) {
+        vector<Node*>& route = routes[v];
+        if (groups[v].empty()) {
+            route.push_back(depot);
+            return;
+        }
+        vector<Node*> stops = {depot};
+        stops.insert(stops.end(), groups[v].begin(), groups[v].end());
+        (graph.*solveRoute)(stops, route);
+        if (route.front() != route.back()) route.push_back(route.front());
+        if (seconds > 0) {
+            IteratedLocalSearch search(graph, route, nullptr, pool);
+            search.run(1, seconds, seeds[v]);
+            route = search.getTour();
+            route.pop_back();
+            std::rotate(route.begin(), std::find(route.begin(), route.end(), depot), route.end());
+            route.push_back(depot);
+        }
+        costs[v] = graph.getTourWeight(route);
+    });
+    return getTotalCost();
+}
+
+const vector<vector<Node*>>& MultiVehicle::getGroups() const {
+    return groups;
+}
+
+const vector<vector<Node*>>& MultiVehicle::getRoutes() const {
+    return routes;
+}
+
+const vector<double>& MultiVehicle::getCosts() const {
+    return costs;
+}
+
+double MultiVehicle::getTotalCost() const {
+    return std::accumulate(costs.begin(), costs.end(), 0.0);
+}
+
+bool MultiVehicle::parse(const std::string& name, Balance& balance) {
+    if (name == "count") balance = Balance::COUNT;
+    else if (name == "distance") balance = Balance::DISTANCE;
+    else return false;
+    return true;
+}
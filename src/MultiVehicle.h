@@ -0,0 +1,84 @@
+#ifndef PROJETO_DA_2_MULTIVEHICLE_H
+#define PROJETO_DA_2_MULTIVEHICLE_H
+
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "ThreadPool.h"
+
+/**
+ * What the groups of stops of a fleet are balanced by: the number of stops, or the sum of the distances from the depot
+ * to the stops (a stop far away costs its vehicle more than one next to the depot).
+ */
+enum class Balance { COUNT, DISTANCE };
+
+/**
+ * Routes for a fleet of vehicles that all leave from and return to the depot (node 0), cluster-first, route-second: the
+ * stops are swept by their angle around the depot and cut into one arc per vehicle, so each vehicle gets a compact
+ * wedge of the map, and the route of each vehicle is then solved on its own, concurrently with the others.
+ */
+class MultiVehicle {
+public:
+    /**
+     * Constructor of the MultiVehicle class. Splits the stops into the groups of the vehicles. The sweep starts at the
+     * widest angular gap between stops, so that no vehicle gets stops from both sides of it. Graphs without coordinates
+     * (every stop at the depot) are split in the order of the nodes.
+     * @param graph Represents the graph, whose node with id 0 (or first node, if there is none) is the depot
+     * @param type Represents the type of graph, as in loadDataset, which picks the distance policy of the routes. The
+     * distances missing from a toy graph are completed (MatrixDistance::prepare) before anything is measured
+     * @param vehicles Represents the number of vehicles, at least 1
+     * @param balance Represents what the groups are balanced by
+     * @param pool Represents the pool the routes are solved on
+     * @note Time-complexity -> O(V*log(V)) with V being the number of nodes
+     */
+    MultiVehicle(Graph& graph, const std::string& type, unsigned int vehicles, Balance balance = Balance::COUNT, ThreadPool& pool = ThreadPool::shared());
+    /**
+     * Solves the route of every vehicle concurrently: the Triangular Approximation Heuristic over the depot and the stops
+     * of the vehicle, optionally improved by an IteratedLocalSearch worker per route. Builds the edge index of the graph
+     * if it is not up to date.
+     * @param seconds Represents the time budget of the local search of each route, 0 for none
+     * @param seed Represents the seed of the local searches. Each route gets its own one drawn from it
+     * @return The total cost of the routes
+     * @note Time-complexity -> O(max over the vehicles of (E*log(E) + seconds)) with E being the number of edges between the
+     * nodes of a route, given a thread per vehicle
+     */
+    double run(double seconds = 0, unsigned int seed = 1);
+    /**
+     * Returns the stops of each vehicle, in sweep order and without the depot.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<std::vector<Node*>>& getGroups() const;
+    /**
+     * Returns the route of each vehicle solved by the last call of run, starting and ending at the depot (just the depot
+     * for a vehicle without stops).
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<std::vector<Node*>>& getRoutes() const;
+    /**
+     * Returns the cost of each route, by getTourWeight.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<double>& getCosts() const;
+    /**
+     * Returns the sum of getCosts.
+     * @note Time-complexity -> O(m) with m being the number of vehicles
+     */
+    [[nodiscard]] double getTotalCost() const;
+    /**
+     * Parses the name of a balance: "count" or "distance".
+     * @return True if the name is known, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    static bool parse(const std::string& name, Balance& balance);
+
+private:
+    Graph& graph;
+    ThreadPool& pool;
+    double (Graph::*solveRoute)(vector<Node*>, vector<Node*>&);    // the Cluster instantiation of the heuristic for the type
+    Node* depot = nullptr;
+    std::vector<std::vector<Node*>> groups;
+    std::vector<std::vector<Node*>> routes;
+    std::vector<double> costs;
+};
+
+#endif //PROJETO_DA_2_MULTIVEHICLE_H
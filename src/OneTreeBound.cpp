@@ -0,0 +1,270 @@
+#include "OneTreeBound.h"
+#include <cmath>
+#include "KdTree.h"
+#include "Stats.h"
+
+static const unsigned int NEAREST = 10;
+static const unsigned int PERIOD = 30;
+static const double MIN_LAMBDA = 1e-3;
+static const double EPSILON = 1e-9;
+
+OneTreeBound::OneTreeBound(Graph& graph, ThreadPool& pool): pool(pool), nodes(graph.getNodeSet()) {
+    if (!graph.isEdgeIndexed()) graph.indexEdges();
+    unsigned int n = nodes.size();
+    complete = n <= MAX_COMPLETE_NODES;
+    penalties.assign(n, 0);
+    if (n == 2) firstEdges.push_back({graph.getDistance(nodes[0], nodes[1]), 0, 1, 1});
+    if (n < 3) return;
+    unsigned int tasks = std::min(pool.size() + 1, n);
+
+    // candidate pairs (i, j), i < j, found by each task: the NEAREST closest nodes of every node, plus its edges
+    vector<vector<pair<unsigned int, unsigned int>>> taskPairs(tasks);
+    if (complete) {
+        distances.resize((unsigned long long) n * n);
+        pool.parallelFor(tasks, [&](unsigned int t) {
+            vector<pair<double, unsigned int>> row(n);
+            for (unsigned int i = t; i < n; i += tasks) {
+                for (unsigned int j = 0; j < n; j++) {
+                    distances[(unsigned long long) i * n + j] = i == j ? 0 : graph.getDistance(nodes[i], nodes[j]);
+                    row[j] = {distances[(unsigned long long) i * n + j], j};
+                }
+                unsigned int nearest = std::min(NEAREST + 1, n);
+                std::partial_sort(row.begin(), row.begin() + nearest, row.end());
+                for (unsigned int k = 0; k < nearest; k++) {
+                    if (row[k].second != i) taskPairs[t].emplace_back(std::min(i, row[k].second), std::max(i, row[k].second));
+                }
+            }
+        });
+    } else {
+        unordered_map<const Node*, unsigned int> position;
+        for (unsigned int i = 0; i < n; i++) position.emplace(nodes[i], i);
+        KdTree tree(nodes, graph.getPrecision().getStorage());
+        pool.parallelFor(tasks, [&](unsigned int t) {
+            for (unsigned int i = t; i < n; i += tasks) {
+                vector<unsigned int> neighbours = tree.nearest(nodes[i]->getLon(), nodes[i]->getLat(), NEAREST + 1);
+                for (Edge* edge : nodes[i]->getAdj()) {
+                    auto it = position.find(edge->getDest());
+                    if (it != position.end()) neighbours.push_back(it->second);
+                }
+                for (unsigned int j : neighbours) {
+                    if (j != i) taskPairs[t].emplace_back(std::min(i, j), std::max(i, j));
+                }
+            }
+        });
+    }
+    // the nearest relation is not symmetric, so a pair may have been found from either endpoint, or from both
+    vector<pair<unsigned int, unsigned int>> pairs;
+    for (auto& found : taskPairs) pairs.insert(pairs.end(), found.begin(), found.end());
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    if (complete) {
+        for (unsigned int j = 1; j < n; j++) firstEdges.push_back({distances[j], 0, j, j});
+        for (auto [i, j] : pairs) {
+            if (i != 0) edges.push_back({distances[(unsigned long long) i * n + j], i, j, (unsigned int) edges.size()});
+        }
+        return;
+    }
+    unsigned int firstCount = 0;
+    while (firstCount < pairs.size() && pairs[firstCount].first == 0) firstCount++;
+    edges.resize(pairs.size() - firstCount);
+    firstEdges.resize(firstCount);
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        for (unsigned int k = t; k < pairs.size(); k += tasks) {
+            auto [i, j] = pairs[k];
+            PackedEdge edge = {graph.getDistance(nodes[i], nodes[j]), i, j, 0};
+            if (k < firstCount) firstEdges[k] = edge;
+            else edges[k - firstCount] = edge, edges[k - firstCount].id = k - firstCount;
+        }
+    });
+}
+
+bool OneTreeBound::spanningTree(const vector<double>& pi, vector<unsigned int>& selected, double& weight) const {
+    unsigned int n = nodes.size();
+    // the first node is left out of the spanning tree, so the others are shifted down by one
+    vector<PackedEdge> modified(edges);
+    for (PackedEdge& e : modified) {
+        e.weight += pi[e.u] + pi[e.v];
+        e.u--;
+        e.v--;
+    }
+    ParallelMST mst(n - 1, std::move(modified), pool);
+    weight = mst.run();
+    selected = mst.getSelected();
+    return selected.size() == n - 2;
+}
+
+unsigned int OneTreeBound::addViolatedPairs(const vector<double>& pi, const vector<unsigned int>& selected) {
+    unsigned int n = nodes.size();
+    vector<vector<pair<unsigned int, double>>> tree(n);
+    for (unsigned int id : selected) {
+        double w = edges[id].weight + pi[edges[id].u] + pi[edges[id].v];
+        tree[edges[id].u].emplace_back(edges[id].v, w);
+        tree[edges[id].v].emplace_back(edges[id].u, w);
+    }
+
+    // a pair lighter than the heaviest edge of the path of the tree between its nodes would replace that edge; each node
+    // adds the lightest such pair to a node after it, the nodes of other components counting as infinitely far
+    unsigned int tasks = std::min(pool.size() + 1, n - 1);
+    vector<vector<PackedEdge>> taskPairs(tasks);
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        // the penalties can make weights negative, so the nodes not reached are marked apart
+        vector<double> heaviest(n);
+        vector<bool> reached(n);
+        vector<unsigned int> stack;
+        for (unsigned int root = 1 + t; root < n; root += tasks) {
+            std::fill(reached.begin(), reached.end(), false);
+            reached[root] = true;
+            heaviest[root] = -std::numeric_limits<double>::infinity();
+            stack.assign(1, root);
+            while (!stack.empty()) {
+                unsigned int u = stack.back();
+                stack.pop_back();
+                for (auto [v, w] : tree[u]) {
+                    if (!reached[v]) {
+                        reached[v] = true;
+                        heaviest[v] = std::max(heaviest[u], w);
+                        stack.push_back(v);
+                    }
+                }
+            }
+            const double* row = distances.data() + (unsigned long long) root * n;
+            PackedEdge lightest = {std::numeric_limits<double>::infinity(), root, 0, 0};
+            for (unsigned int v = root + 1; v < n; v++) {
+                double w = row[v] + pi[root] + pi[v];
+                if ((!reached[v] || w < heaviest[v] - EPSILON * std::abs(heaviest[v])) && w < lightest.weight) {
+                    lightest = {w, root, v, 0};
+                }
+            }
+            if (lightest.v != 0) taskPairs[t].push_back({row[lightest.v], root, lightest.v, 0});
+        }
+    });
+
+    unsigned int added = 0;
+    for (auto& found : taskPairs) {
+        for (PackedEdge& e : found) {
+            e.id = edges.size();
+            edges.push_back(e);
+            added++;
+        }
+    }
+    return added;
+}
+
+double OneTreeBound::solveOneTree(const vector<double>& pi, vector<int>& degrees, vector<pair<unsigned int, unsigned int>>* tree) {
+    unsigned int n = nodes.size();
+    vector<unsigned int> selected;
+    double weight;
+    while (true) {
+        bool spanning = spanningTree(pi, selected, weight);
+        if (!complete) {
+            if (!spanning) return std::numeric_limits<double>::quiet_NaN();
+            break;
+        }
+        if (addViolatedPairs(pi, selected) == 0) break;
+    }
+
+    degrees.assign(n, 0);
+    for (unsigned int id : selected) {
+        degrees[edges[id].u]++;
+        degrees[edges[id].v]++;
+    }
+    if (firstEdges.size() < 2) return std::numeric_limits<double>::quiet_NaN();
+    unsigned int lightest[2] = {0, 1};
+    auto firstWeight = [&](unsigned int k) { return firstEdges[k].weight + pi[firstEdges[k].v]; };
+    if (firstWeight(1) < firstWeight(0)) std::swap(lightest[0], lightest[1]);
+    for (unsigned int k = 2; k < firstEdges.size(); k++) {
+        if (firstWeight(k) < firstWeight(lightest[0])) lightest[1] = lightest[0], lightest[0] = k;
+        else if (firstWeight(k) < firstWeight(lightest[1])) lightest[1] = k;
+    }
+    for (unsigned int k : lightest) {
+        weight += firstWeight(k) + pi[0];
+        degrees[0]++;
+        degrees[firstEdges[k].v]++;
+    }
+    if (tree != nullptr) {
+        tree->clear();
+        for (unsigned int id : selected) tree->emplace_back(edges[id].u, edges[id].v);
+        for (unsigned int k : lightest) tree->emplace_back(0, firstEdges[k].v);
+    }
+
+    double penaltySum = 0;
+    for (double p : pi) penaltySum += p;
+    return weight - 2 * penaltySum;
+}
+
+bool OneTreeBound::run(double upperBound, unsigned int maxIterations) {
+    STATS_PHASE("onetree");
+    unsigned int n = nodes.size();
+    penalties.assign(n, 0);
+    iterations = 0;
+    if (n < 3) {
+        bound = n == 2 ? 2 * firstEdges[0].weight : 0;    // there and back
+        return true;
+    }
+
+    vector<double> pi(n, 0);
+    vector<int> degrees;
+    double lambda = 2;
+    unsigned int sinceBest = 0;
+    while (iterations < maxIterations) {
+        double value = solveOneTree(pi, degrees);
+        iterations++;
+        if (std::isnan(value)) {
+            bound = 0;
+            penalties.assign(n, 0);
+            return false;
+        }
+        if (iterations == 1 || value > bound + EPSILON * std::abs(bound)) {
+            bound = value;
+            penalties = pi;
+            sinceBest = 0;
+        } else if (++sinceBest >= PERIOD) {
+            lambda /= 2;
+            sinceBest = 0;
+            if (lambda < MIN_LAMBDA) break;
+        }
+
+        double norm = 0;
+        for (int d : degrees) norm += (d - 2) * (d - 2);
+        if (norm == 0) break;   // every node has degree 2, so the 1-tree is an optimal cycle
+        double target = upperBound > 0 ? upperBound : 1.05 * bound;
+        if (target - value <= EPSILON * target) break;
+        double step = lambda * (target - value) / norm;
+        for (unsigned int i = 0; i < n; i++) pi[i] += step * (degrees[i] - 2);
+    }
+    return true;
+}
+
+double OneTreeBound::getBound() const {
+    return bound;
+}
+
+double OneTreeBound::getGap(double tourLength) const {
+    return bound > 0 ? (tourLength - bound) / bound : 0;
+}
+
+const vector<double>& OneTreeBound::getPenalties() const {
+    return penalties;
+}
+
+vector<pair<unsigned int, unsigned int>> OneTreeBound::getOneTree() {
+    vector<pair<unsigned int, unsigned int>> tree;
+    if (nodes.size() == 2) tree.emplace_back(0, 1);
+    if (nodes.size() < 3) return tree;
+    vector<int> degrees;
+    if (std::isnan(solveOneTree(penalties, degrees, &tree))) tree.clear();
+    return tree;
+}
+
+const vector<Node*>& OneTreeBound::getNodes() const {
+    return nodes;
+}
+
+bool OneTreeBound::isComplete() const {
+    return complete;
+}
+
+unsigned int OneTreeBound::getIterations() const {
+    return iterations;
+}
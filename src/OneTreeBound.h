@@ -0,0 +1,120 @@
+#ifndef PROJETO_DA_2_ONETREEBOUND_H
+#define PROJETO_DA_2_ONETREEBOUND_H
+
+#include <vector>
+#include "Graph.h"
+#include "ParallelMST.h"
+#include "ThreadPool.h"
+
+/**
+ * Held-Karp lower bound of the length of the hamiltonian cycles of a graph. A 1-tree is a spanning tree of every node but
+ * the first one plus the two shortest edges of the first node; every cycle is a 1-tree, so the lightest 1-tree is never
+ * longer than the shortest cycle. Adding a penalty pi[i] to every edge of node i adds 2*sum(pi) to every cycle but not to
+ * every 1-tree, which lets subgradient optimization of the penalties push the lightest 1-tree towards a cycle.
+ */
+class OneTreeBound {
+public:
+    /**
+     * Constructor of the OneTreeBound class. If the graph has at most MAX_COMPLETE_NODES nodes the 1-trees are taken over
+     * every pair of nodes, weighted by getDistance, and the bound holds for every tour weighted by getTourWeight; the
+     * spanning trees are solved by kruskal over the NEAREST closest nodes of each node and then checked against every
+     * pair. Otherwise they are taken over the edges of the graph plus the NEAREST closest nodes by coordinates of each
+     * node, and the bound only holds for the tours that use those edges alone. The solvers do not keep to them (they join
+     * any two nodes through getDistance), so it is then no bound of their tours, only a guide (see isComplete).
+     * Builds the edge index of the graph if it is not up to date.
+     * @param graph Represents the graph to bound
+     * @param pool Represents the pool the edges are built and the spanning trees are solved on
+     * @note Time-complexity -> O(V^2*log(K)) if complete, O(V*(K*log(V) + D)) otherwise, with K being NEAREST and D the degree of the nodes
+     */
+    explicit OneTreeBound(Graph& graph, ThreadPool& pool = ThreadPool::shared());
+    /**
+     * Runs the subgradient optimization: each iteration solves the lightest 1-tree with the current penalties, and moves
+     * the penalty of every node by step * (degree - 2), with step = lambda * (upperBound - bound) / |degree - 2|^2.
+     * Lambda starts at 2 and is halved after PERIOD iterations without a better bound. Stops when lambda gets too small,
+     * after maxIterations, when the bound reaches the upper bound or when the 1-tree is a cycle (which is then optimal).
+     * @param upperBound Represents the length of a known tour, e.g. from TriangularApproximationHeuristic. If 0, 5% over
+     * the current bound is used instead
+     * @param maxIterations Represents the maximum number of 1-trees solved
+     * @return True if a 1-tree exists, false if the edges used do not connect the graph (the bound is then 0)
+     * @note Time-complexity -> O(I * (E + V*log(V)*log(E/V))) with I being the number of iterations and E the number of
+     * candidate edges, plus O(V^2) per spanning tree if complete
+     */
+    bool run(double upperBound = 0, unsigned int maxIterations = 1000);
+    /**
+     * Returns the best bound found by the last call of run.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double getBound() const;
+    /**
+     * Returns how much longer a tour is than the bound, relative to the bound: (tourLength - bound) / bound.
+     * @param tourLength Represents the length of the tour
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double getGap(double tourLength) const;
+    /**
+     * Returns the penalties of the best bound, aligned with getNodes. getDistance(i, j) + pi[i] + pi[j] is a better guide
+     * than getDistance(i, j) to the edges of the optimal tour, and with the bound it tells that no tour through an edge can
+     * be shorter than the bound plus the increase of the 1-tree when that edge is forced into it.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<double>& getPenalties() const;
+    /**
+     * Returns the edges of the lightest 1-tree with the penalties of getPenalties, as pairs of positions in getNodes; the
+     * two edges of the first node come last. Empty if there is no 1-tree.
+     * @note Time-complexity -> The one of an iteration of run
+     */
+    [[nodiscard]] std::vector<std::pair<unsigned int, unsigned int>> getOneTree();
+    /**
+     * Returns the nodes of the graph, in the order of getPenalties.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<Node*>& getNodes() const;
+    /**
+     * Checks if the 1-trees are taken over every pair of nodes.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool isComplete() const;
+    /**
+     * Returns the number of 1-trees solved by the last call of run.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int getIterations() const;
+
+    static const unsigned int MAX_COMPLETE_NODES = 2000;
+
+private:
+    /**
+     * Solves the lightest 1-tree with the given penalties and writes the degree of every node in it. If complete, the
+     * pairs found by addViolatedPairs are added to the candidate edges until the spanning tree passes the check.
+     * @param tree If not nullptr, represents the vector to which the edges of the 1-tree are written, as in getOneTree
+     * @return The weight of the 1-tree minus 2*sum(penalties), or NaN if there is none
+     */
+    double solveOneTree(const std::vector<double>& penalties, std::vector<int>& degrees,
+                        std::vector<std::pair<unsigned int, unsigned int>>* tree = nullptr);
+    /**
+     * Runs kruskal over the candidate edges of every node but the first one, with the given penalties.
+     * @param selected Represents the vector to which the ids of the edges of the tree are written
+     * @param weight Represents the variable to which the weight of the tree is written
+     * @return True if the tree spans every node but the first one, false if it is a forest
+     */
+    bool spanningTree(const std::vector<double>& penalties, std::vector<unsigned int>& selected, double& weight) const;
+    /**
+     * Checks a spanning tree against every pair of nodes: the tree is minimum if no pair is lighter than the heaviest
+     * edge on the path between its nodes. Otherwise adds to the candidate edges, for each node, the lightest such pair.
+     * @return The number of pairs added
+     * @note Time-complexity -> O(V^2 / T) with T being the number of threads
+     */
+    unsigned int addViolatedPairs(const std::vector<double>& penalties, const std::vector<unsigned int>& selected);
+
+    ThreadPool& pool;
+    std::vector<Node*> nodes;
+    std::vector<double> distances;          // V x V, if complete
+    std::vector<PackedEdge> edges;          // candidate edges between the nodes other than the first one
+    std::vector<PackedEdge> firstEdges;     // edges of the first node
+    bool complete;
+    double bound = 0;
+    std::vector<double> penalties;
+    unsigned int iterations = 0;
+};
+
+#endif //PROJETO_DA_2_ONETREEBOUND_H
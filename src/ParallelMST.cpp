@@ -0,0 +1,97 @@
+#include "ParallelMST.h"
+#include "Stats.h"
+#include <algorithm>
+
+static const unsigned int BASE_CASE_SIZE = 1 << 14;     // below this many edges, sort and run kruskal directly
+static const unsigned int PARALLEL_MIN_SIZE = 1 << 16;  // below this many edges, partitions and filters are sequential
+
+static bool lighter(const PackedEdge& e1, const PackedEdge& e2) {
+    return e1.weight < e2.weight || (e1.weight == e2.weight && e1.id < e2.id);
+}
+
+ParallelMST::ParallelMST(unsigned int numNodes, std::vector<PackedEdge> edges, ThreadPool& pool):
+    numNodes(numNodes), edges(std::move(edges)), pool(pool), ufds(0) {}
+
+const std::vector<unsigned int>& ParallelMST::getSelected() const {
+    return selected;
+}
+
+double ParallelMST::run() {
+    ufds = ConcurrentUFDS(numNodes);
+    selected.clear();
+    totalWeight = 0;
+    if (numNodes > 1) filterKruskal(0, edges.size());
+    buffer.clear();
+    buffer.shrink_to_fit();
+    return totalWeight;
+}
+
+template<typename Predicate>
+unsigned int ParallelMST::compact(unsigned int lo, unsigned int hi, Predicate keep) {
+    unsigned int size = hi - lo;
+    if (size < PARALLEL_MIN_SIZE) {
+        auto middle = std::stable_partition(edges.begin() + lo, edges.begin() + hi, keep);
+        return middle - (edges.begin() + lo);
+    }
+
+    unsigned int tasks = pool.size() + 1;
+    std::vector<unsigned int> kept(tasks + 1, 0), rejected(tasks + 1, 0);
+    auto chunk = [lo, size, tasks](unsigned int t) { return lo + (unsigned int) ((unsigned long long) size * t / tasks); };
+
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        for (unsigned int i = chunk(t); i < chunk(t + 1); i++) {
+            if (keep(edges[i])) kept[t + 1]++;
+            else rejected[t + 1]++;
+        }
+    });
+    for (unsigned int t = 0; t < tasks; t++) {
+        kept[t + 1] += kept[t];
+        rejected[t + 1] += rejected[t];
+    }
+
+    if (buffer.size() < edges.size()) buffer.resize(edges.size());
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        unsigned int k = lo + kept[t], r = lo + kept[tasks] + rejected[t];
+        for (unsigned int i = chunk(t); i < chunk(t + 1); i++) {
+            if (keep(edges[i])) buffer[k++] = edges[i];
+            else buffer[r++] = edges[i];
+        }
+    });
+    pool.parallelFor(tasks, [&](unsigned int t) {
+        std::copy(buffer.begin() + chunk(t), buffer.begin() + chunk(t + 1), edges.begin() + chunk(t));
+    });
+    return kept[tasks];
+}
+
+void ParallelMST::baseKruskal(unsigned int lo, unsigned int hi) {
+    std::sort(edges.begin() + lo, edges.begin() + hi, lighter);
+    for (unsigned int i = lo; i < hi && selected.size() < numNodes - 1; i++) {
+        const PackedEdge& e = edges[i];
+        STATS_COUNT(MST_EDGES_SCANNED, 1);
+        if (ufds.linkSets(e.u, e.v)) {
+            selected.push_back(e.id);
+            totalWeight += e.weight;
+        }
+    }
+}
+
+void ParallelMST::filterKruskal(unsigned int lo, unsigned int hi) {
+    if (selected.size() == numNodes - 1 || lo >= hi) return;
+    if (hi - lo <= BASE_CASE_SIZE) {
+        baseKruskal(lo, hi);
+        return;
+    }
+
+    // median of 31 evenly spaced edges; the keys are all distinct, so both sides of the pivot get edges
+    std::vector<PackedEdge> sample;
+    for (unsigned int s = 0; s < 31; s++) sample.push_back(edges[lo + (unsigned int) ((unsigned long long) (hi - lo - 1) * s / 30)]);
+    std::nth_element(sample.begin(), sample.begin() + 15, sample.end(), lighter);
+    PackedEdge pivot = sample[15];
+
+    unsigned int mid = lo + compact(lo, hi, [&pivot](const PackedEdge& e) { return !lighter(pivot, e); });
+    filterKruskal(lo, mid);
+    if (selected.size() == numNodes - 1) return;
+
+    unsigned int kept = compact(mid, hi, [this](const PackedEdge& e) { return !ufds.isSameSet(e.u, e.v); });
+    filterKruskal(mid, mid + kept);
+}
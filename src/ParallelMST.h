@@ -0,0 +1,68 @@
+#ifndef PROJETO_DA_2_PARALLELMST_H
+#define PROJETO_DA_2_PARALLELMST_H
+
+#include <vector>
+#include "ThreadPool.h"
+#include "UFDS.h"
+
+/**
+ * Edge packed for the MST engine: its weight, the indexes of its endpoints and an id chosen by the caller (e.g. the
+ * position of the Edge* it came from), which also breaks ties between equal weights.
+ */
+struct PackedEdge {
+    double weight;
+    unsigned int u, v;
+    unsigned int id;
+};
+
+class ParallelMST {
+public:
+    /**
+     * Constructor of the ParallelMST class.
+     * @param numNodes Represents the number of nodes. The endpoints of the edges must be lower than it
+     * @param edges Represents the edges of the graph, one per undirected edge
+     * @param pool Represents the pool used for the parallel partitions and filters
+     * @note Time-complexity -> O(1)
+     */
+    ParallelMST(unsigned int numNodes, std::vector<PackedEdge> edges, ThreadPool& pool = ThreadPool::shared());
+    /**
+     * Implementation of the filter-kruskal algorithm. Partitions the edges around a pivot weight in parallel, solves the
+     * lighter half, removes in parallel the heavier edges whose endpoints are already connected and then solves the rest.
+     * The edges are taken in (weight, id) order, so the selected edges are exactly the ones a sequential kruskal with that
+     * order selects.
+     * @return The sum of the weight of the selected edges
+     * @note Time-complexity -> O(E + V*log(V)*log(E/V)) expected work, with most of the O(E) part split across the pool
+     */
+    double run();
+    /**
+     * Returns the ids of the edges selected by the last call of run, in the order they were selected.
+     * @return vector with the ids of the selected edges
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] const std::vector<unsigned int>& getSelected() const;
+private:
+    /**
+     * Solves the edges in [lo, hi), which are all heavier than the ones already processed.
+     */
+    void filterKruskal(unsigned int lo, unsigned int hi);
+    /**
+     * Sorts the edges in [lo, hi) and runs the sequential kruskal over them.
+     */
+    void baseKruskal(unsigned int lo, unsigned int hi);
+    /**
+     * Moves the edges of [lo, hi) that satisfy keep to the front of the range, in parallel, preserving their relative order.
+     * @return The number of edges kept
+     */
+    template<typename Predicate>
+    unsigned int compact(unsigned int lo, unsigned int hi, Predicate keep);
+
+    unsigned int numNodes;
+    std::vector<PackedEdge> edges;
+    std::vector<PackedEdge> buffer;
+    ThreadPool& pool;
+    ConcurrentUFDS ufds;
+    std::vector<unsigned int> selected;
+    double totalWeight = 0;
+};
+
+#endif //PROJETO_DA_2_PARALLELMST_H
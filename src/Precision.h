@@ -0,0 +1,234 @@
+#ifndef PROJETO_DA_2_PRECISION_H
+#define PROJETO_DA_2_PRECISION_H
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * How the weights and coordinates of a graph are stored.
+ * DOUBLE keeps them as read. FLOAT32 rounds them to the nearest float, a relative error of at most 2^-24 (6e-8) per
+ * weight, so a tour of n edges is off by at most n*6e-8 times its length. FIXED_POINT rounds the weights to the nearest
+ * multiple of 1/scale, an error of at most 0.5/scale per weight (n*0.5/scale per tour), and the coordinates to the nearest
+ * 1e-7 degree (about 1 cm); weights are then kept as 32-bit integers, so they must lie within +-(2^31-1)/scale, and sums
+ * of them are exact. The compact modes keep 4-byte weights in the flat arrays the solvers read (EdgeIndex and the edges
+ * of a Subgraph, through WeightArray) and 16-byte points in a KdTree; Node and Edge keep doubles, rounded to the mode.
+ */
+enum class Storage { DOUBLE, FLOAT32, FIXED_POINT };
+
+class Precision {
+public:
+    static constexpr double DEFAULT_SCALE = 100;
+    static constexpr double COORDINATE_SCALE = 1e7;
+
+    /**
+     * Constructor of the Precision class.
+     * @param storage Represents the storage mode
+     * @param scale Represents the number of fixed-point units per unit of weight, only used by FIXED_POINT
+     * @note Time-complexity -> O(1)
+     */
+    explicit Precision(Storage storage = Storage::DOUBLE, double scale = DEFAULT_SCALE): storage(storage), scale(scale) {}
+
+    [[nodiscard]] Storage getStorage() const { return storage; }
+    [[nodiscard]] double getScale() const { return scale; }
+
+    /**
+     * Returns the weight w as it is stored, i.e. rounded to the precision of the mode.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double weight(double w) const {
+        switch (storage) {
+            case Storage::FLOAT32: return (double) (float) w;
+            case Storage::FIXED_POINT: return decode(encode(w));
+            default: return w;
+        }
+    }
+    /**
+     * Returns the coordinate c (in degrees) as it is stored, i.e. rounded to the precision of the mode.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double coordinate(double c) const {
+        switch (storage) {
+            case Storage::FLOAT32: return (double) (float) c;
+            case Storage::FIXED_POINT: return std::round(c * COORDINATE_SCALE) / COORDINATE_SCALE;
+            default: return c;
+        }
+    }
+    /**
+     * Returns the weight w in fixed-point units, clamped to the range of a 32-bit integer.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] int32_t encode(double w) const {
+        double units = std::round(w * scale);
+        if (units >= INT32_MAX) return INT32_MAX;
+        if (units <= -INT32_MAX) return -INT32_MAX;
+        return (int32_t) units;
+    }
+    /**
+     * Returns the weight of q fixed-point units.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double decode(int64_t q) const { return (double) q / scale; }
+
+    /**
+     * Parses the name of a storage mode: "double", "float32" or "fixed".
+     * @return True if the name is known, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    static bool parse(const std::string& name, Storage& storage) {
+        if (name == "double") storage = Storage::DOUBLE;
+        else if (name == "float32") storage = Storage::FLOAT32;
+        else if (name == "fixed") storage = Storage::FIXED_POINT;
+        else return false;
+        return true;
+    }
+    /**
+     * Returns the name of a storage mode, as parsed by parse.
+     * @note Time-complexity -> O(1)
+     */
+    static const char* name(Storage storage) {
+        switch (storage) {
+            case Storage::FLOAT32: return "float32";
+            case Storage::FIXED_POINT: return "fixed";
+            default: return "double";
+        }
+    }
+
+private:
+    Storage storage;
+    double scale;
+};
+
+/**
+ * Array of weights kept in the compact form of a storage mode: only the vector of the mode is used, so FLOAT32 and
+ * FIXED_POINT take 4 bytes per weight instead of 8. The weights are read back as doubles, rounded as by Precision::weight.
+ */
+class WeightArray {
+public:
+    /**
+     * Constructor of the WeightArray class, empty.
+     * @param precision Represents the storage mode of the weights
+     * @note Time-complexity -> O(1)
+     */
+    explicit WeightArray(Precision precision = Precision()): precision(precision) {}
+
+    [[nodiscard]] const Precision& getPrecision() const { return precision; }
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    /**
+     * Removes every weight and changes the storage mode.
+     * @note Time-complexity -> O(1), the memory is given back
+     */
+    void reset(Precision newPrecision) {
+        precision = newPrecision;
+        doubles = {};
+        floats = {};
+        fixed = {};
+        count = 0;
+    }
+    /**
+     * Sets the size of the array to n, every weight being 0.
+     * @note Time-complexity -> O(n)
+     */
+    void assign(std::size_t n) {
+        switch (precision.getStorage()) {
+            case Storage::FLOAT32: floats.assign(n, 0); break;
+            case Storage::FIXED_POINT: fixed.assign(n, 0); break;
+            default: doubles.assign(n, 0);
+        }
+        count = n;
+    }
+    /**
+     * Appends the weight w.
+     * @note Time-complexity -> O(1) amortized
+     */
+    void push_back(double w) {
+        switch (precision.getStorage()) {
+            case Storage::FLOAT32: floats.push_back((float) w); break;
+            case Storage::FIXED_POINT: fixed.push_back(precision.encode(w)); break;
+            default: doubles.push_back(w);
+        }
+        count++;
+    }
+    /**
+     * Returns the weight in position i.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double get(std::size_t i) const {
+        switch (precision.getStorage()) {
+            case Storage::FLOAT32: return floats[i];
+            case Storage::FIXED_POINT: return precision.decode(fixed[i]);
+            default: return doubles[i];
+        }
+    }
+    /**
+     * Replaces the weight in position i with w.
+     * @note Time-complexity -> O(1)
+     */
+    void set(std::size_t i, double w) {
+        switch (precision.getStorage()) {
+            case Storage::FLOAT32: floats[i] = (float) w; break;
+            case Storage::FIXED_POINT: fixed[i] = precision.encode(w); break;
+            default: doubles[i] = w;
+        }
+    }
+    /**
+     * Checks if the weight in position i is lighter than the one in position j, comparing the stored values (integers with
+     * FIXED_POINT, so equal weights always compare equal).
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool less(std::size_t i, std::size_t j) const {
+        switch (precision.getStorage()) {
+            case Storage::FLOAT32: return floats[i] < floats[j];
+            case Storage::FIXED_POINT: return fixed[i] < fixed[j];
+            default: return doubles[i] < doubles[j];
+        }
+    }
+    /**
+     * Returns the number of bytes taken by the array.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] std::size_t memoryBytes() const {
+        return doubles.capacity() * sizeof(double) + floats.capacity() * sizeof(float) + fixed.capacity() * sizeof(int32_t);
+    }
+
+private:
+    Precision precision;
+    std::vector<double> doubles;        // DOUBLE
+    std::vector<float> floats;          // FLOAT32
+    std::vector<int32_t> fixed;         // FIXED_POINT
+    std::size_t count = 0;
+};
+
+/**
+ * Sum of weights in a storage mode. With FIXED_POINT the weights are added as 64-bit integer units, so the sum is exact
+ * and does not depend on the order of the additions; the other modes add doubles.
+ */
+class WeightSum {
+public:
+    explicit WeightSum(const Precision& precision): precision(precision) {}
+
+    /**
+     * Adds the weight w to the sum.
+     * @note Time-complexity -> O(1)
+     */
+    void add(double w) {
+        if (precision.getStorage() == Storage::FIXED_POINT) units += precision.encode(w);
+        else weight += w;
+    }
+    /**
+     * Returns the sum of the weights added so far.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double value() const {
+        return precision.getStorage() == Storage::FIXED_POINT ? precision.decode(units) : weight;
+    }
+
+private:
+    const Precision& precision;
+    double weight = 0;
+    int64_t units = 0;
+};
+
+#endif //PROJETO_DA_2_PRECISION_H
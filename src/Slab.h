@@ -0,0 +1,57 @@
+#ifndef PROJETO_DA_2_SLAB_H
+#define PROJETO_DA_2_SLAB_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Arena of objects of type T: objects are constructed one after the other in large blocks, and all the memory is given
+ * back at once by release. Objects are never freed one by one, and release does not run their destructors, so objects
+ * that own memory (e.g. vectors) must be destroyed by whoever uses the slab before it is released.
+ */
+template<typename T>
+class Slab {
+public:
+    Slab() = default;
+    ~Slab() { release(); }
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+
+    /**
+     * Constructs an object in the current block, starting a new block twice the size of the last one (up to MAX_BLOCK
+     * objects) when it is full.
+     * @param args Represents the arguments of the constructor of T
+     * @return Pointer to the new object, valid until release is called
+     * @note Time-complexity -> O(1) amortized
+     */
+    template<typename... Args>
+    T* create(Args&&... args) {
+        if (used == capacity) {
+            capacity = blocks.empty() ? MIN_BLOCK : std::min(capacity * 2, MAX_BLOCK);
+            blocks.push_back(static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T)))));
+            used = 0;
+        }
+        return new (blocks.back() + used++) T(std::forward<Args>(args)...);
+    }
+    /**
+     * Gives back the memory of every object created by the (this) slab, without running their destructors.
+     * @note Time-complexity -> O(B) with B being the number of blocks
+     */
+    void release() {
+        for (T* block : blocks) ::operator delete(block, std::align_val_t(alignof(T)));
+        blocks.clear();
+        used = capacity = 0;
+    }
+
+private:
+    static constexpr std::size_t MIN_BLOCK = 256;
+    static constexpr std::size_t MAX_BLOCK = 1 << 20;
+
+    std::vector<T*> blocks;
+    std::size_t used = 0, capacity = 0;   // objects created in and size of the last block
+};
+
+#endif //PROJETO_DA_2_SLAB_H
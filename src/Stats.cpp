@@ -0,0 +1,155 @@
+#include "Stats.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+static const unsigned int MAX_EVENTS = 1 << 20;
+static const char* COUNTER_NAMES[Stats::NUM_COUNTERS] = {
+    "kmeans_iterations", "distance_evaluations", "max_recursion_depth", "bb_expansions", "bb_prunes", "mst_edges_scanned"
+};
+
+std::atomic<bool> Stats::enabled{false};
+
+namespace {
+    struct Event {
+        const char* name;
+        unsigned int thread;
+        long long start, duration;
+    };
+    struct PhaseTotal {
+        std::string name;
+        unsigned long long calls;
+        long long duration;
+    };
+
+    // everything below is guarded by mutex; counters of live threads are only read under it
+    std::mutex mutex;
+    std::vector<std::atomic<unsigned long long>*> liveCounters;
+    unsigned long long retired[Stats::NUM_COUNTERS] = {};
+    unsigned int nextThread = 0;
+    std::vector<Event> events;
+    std::vector<PhaseTotal> phases;
+
+    long long now() {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void merge(unsigned long long& total, unsigned long long value, int counter) {
+        if (counter == Stats::RECURSION_DEPTH) total = std::max(total, value);
+        else total += value;
+    }
+}
+
+Stats::ThreadCounters::ThreadCounters() {
+    std::lock_guard<std::mutex> lock(mutex);
+    thread = nextThread++;
+    liveCounters.push_back(values);
+}
+
+Stats::ThreadCounters::~ThreadCounters() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int c = 0; c < NUM_COUNTERS; c++) merge(retired[c], values[c].load(std::memory_order_relaxed), c);
+    liveCounters.erase(std::find(liveCounters.begin(), liveCounters.end(), values));
+}
+
+Stats::ThreadCounters& Stats::local() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+void Stats::enable(bool on) {
+    now();
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+unsigned long long Stats::get(Counter counter) {
+    std::lock_guard<std::mutex> lock(mutex);
+    unsigned long long total = retired[counter];
+    for (std::atomic<unsigned long long>* values : liveCounters) merge(total, values[counter].load(std::memory_order_relaxed), counter);
+    return total;
+}
+
+void Stats::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        retired[c] = 0;
+        for (std::atomic<unsigned long long>* values : liveCounters) values[c].store(0, std::memory_order_relaxed);
+    }
+    events.clear();
+    phases.clear();
+}
+
+void Stats::record(const char* name, long long start, long long end) {
+    unsigned int thread = local().thread;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (events.size() < MAX_EVENTS) events.push_back({name, thread, start, end - start});
+    for (PhaseTotal& phase : phases) {
+        if (phase.name == name) {
+            phase.calls++;
+            phase.duration += end - start;
+            return;
+        }
+    }
+    phases.push_back({name, 1, end - start});
+}
+
+Stats::Phase::Phase(const char* name): name(name), start(isEnabled() ? now() : -1) {}
+
+Stats::Phase::~Phase() {
+    if (start >= 0) record(name, start, now());
+}
+
+void Stats::print(std::ostream& out) {
+    out << "Stats:\n";
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const PhaseTotal& phase : phases) {
+            out << "  " << phase.name << ": " << phase.calls << (phase.calls == 1 ? " call, " : " calls, ")
+                << phase.duration / 1e6 << " ms\n";
+        }
+    }
+    for (int c = 0; c < NUM_COUNTERS; c++) out << "  " << COUNTER_NAMES[c] << ": " << get((Counter) c) << "\n";
+}
+
+bool Stats::exportJson(const std::string& file) {
+    std::ofstream out(file);
+    if (!out.is_open()) return false;
+    out << std::fixed;
+    out.precision(3);
+    out << "{\"phases\":[";
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (unsigned int p = 0; p < phases.size(); p++) {
+            out << (p ? "," : "") << "{\"name\":\"" << phases[p].name << "\",\"calls\":" << phases[p].calls
+                << ",\"total_ms\":" << phases[p].duration / 1e6 << "}";
+        }
+    }
+    out << "],\"counters\":{";
+    for (int c = 0; c < NUM_COUNTERS; c++) out << (c ? "," : "") << "\"" << COUNTER_NAMES[c] << "\":" << get((Counter) c);
+    out << "}}\n";
+    return out.good();
+}
+
+bool Stats::exportChromeTrace(const std::string& file) {
+    std::ofstream out(file);
+    if (!out.is_open()) return false;
+    out << std::fixed;
+    out.precision(3);
+    out << "{\"traceEvents\":[";
+    long long last = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Event& event : events) {
+            out << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                << ",\"ts\":" << event.start / 1e3 << ",\"dur\":" << event.duration / 1e3 << "},";
+            last = std::max(last, event.start + event.duration);
+        }
+    }
+    out << "\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"ts\":" << last / 1e3 << ",\"args\":{";
+    for (int c = 0; c < NUM_COUNTERS; c++) out << (c ? "," : "") << "\"" << COUNTER_NAMES[c] << "\":" << get((Counter) c);
+    out << "}}\n]}\n";
+    return out.good();
+}
@@ -0,0 +1,124 @@
+#ifndef PROJETO_DA_2_STATS_H
+#define PROJETO_DA_2_STATS_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+/**
+ * Instrumentation of the solvers: phase timers and counters. Everything is off until enable(true) is called, and a
+ * disabled counter or timer costs a single relaxed load. Counters are kept per thread, so enabling them does not make the
+ * threads of the pool fight over a cache line; phases are recorded as events that can be exported as a Chrome trace.
+ * The solvers use the STATS_* macros below, which compile to nothing when TSP_STATS is not defined.
+ */
+class Stats {
+public:
+    enum Counter {
+        KMEANS_ITERATIONS,
+        DISTANCE_EVALUATIONS,
+        RECURSION_DEPTH,        // maximum, not a sum
+        BB_EXPANSIONS,
+        BB_PRUNES,
+        MST_EDGES_SCANNED,
+        NUM_COUNTERS
+    };
+
+    /**
+     * Turns the collection on or off. Turning it on does not clear what was collected before, see reset.
+     * @note Time-complexity -> O(1)
+     */
+    static void enable(bool on);
+    /**
+     * @return True if the stats are being collected, false otherwise
+     * @note Time-complexity -> O(1)
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    /**
+     * Adds n to a counter of the calling thread, if the stats are enabled.
+     * @note Time-complexity -> O(1)
+     */
+    static void count(Counter counter, unsigned long long n = 1) {
+        if (!isEnabled()) return;
+        std::atomic<unsigned long long>& value = local().values[counter];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    /**
+     * Raises a counter of the calling thread to v if it is lower, if the stats are enabled.
+     * @note Time-complexity -> O(1)
+     */
+    static void countMax(Counter counter, unsigned long long v) {
+        if (!isEnabled()) return;
+        std::atomic<unsigned long long>& value = local().values[counter];
+        if (v > value.load(std::memory_order_relaxed)) value.store(v, std::memory_order_relaxed);
+    }
+    /**
+     * Returns the value of a counter over all threads (the maximum for RECURSION_DEPTH, the sum for the others).
+     * @note Time-complexity -> O(T) with T being the number of threads that have counted
+     */
+    static unsigned long long get(Counter counter);
+    /**
+     * Clears the counters and the phases. Meant to be called between runs, not while a solver is running.
+     * @note Time-complexity -> O(T + P) with T being the number of threads and P the number of phases
+     */
+    static void reset();
+    /**
+     * Prints the total time and number of calls of each phase and the value of each counter. Times of phases run
+     * concurrently are summed over the threads, so they can add up to more than the wall time.
+     * @param out Represents the stream to print to
+     * @note Time-complexity -> O(T + P) with T being the number of threads and P the number of phases
+     */
+    static void print(std::ostream& out);
+    /**
+     * Writes the phases and counters as a JSON object to the file given as parameter.
+     * @return True if the file could be written, false otherwise
+     * @note Time-complexity -> O(T + P) with T being the number of threads and P the number of phases
+     */
+    static bool exportJson(const std::string& file);
+    /**
+     * Writes every recorded phase as a Chrome trace event (viewable in chrome://tracing or Perfetto), followed by the
+     * counters, to the file given as parameter. Only the first MAX_EVENTS phases of a run are kept as events.
+     * @return True if the file could be written, false otherwise
+     * @note Time-complexity -> O(T + E) with T being the number of threads and E the number of events
+     */
+    static bool exportChromeTrace(const std::string& file);
+
+    /**
+     * Times the scope it lives in, under the name given as parameter, which must outlive the stats (a string literal).
+     */
+    class Phase {
+    public:
+        explicit Phase(const char* name);
+        ~Phase();
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+    private:
+        const char* name;
+        long long start;
+    };
+
+private:
+    struct ThreadCounters {
+        std::atomic<unsigned long long> values[NUM_COUNTERS] = {};
+        unsigned int thread;
+        ThreadCounters();
+        ~ThreadCounters();
+    };
+    static ThreadCounters& local();
+    static void record(const char* name, long long start, long long end);
+
+    static std::atomic<bool> enabled;
+};
+
+#ifdef TSP_STATS
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+#define STATS_PHASE(name) Stats::Phase STATS_CONCAT(statsPhase, __LINE__)(name)
+#define STATS_COUNT(counter, n) Stats::count(Stats::counter, n)
+#define STATS_MAX(counter, v) Stats::countMax(Stats::counter, v)
+#else
+#define STATS_PHASE(name) ((void) 0)
+#define STATS_COUNT(counter, n) ((void) 0)
+#define STATS_MAX(counter, v) ((void) 0)
+#endif
+
+#endif //PROJETO_DA_2_STATS_H
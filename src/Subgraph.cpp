@@ -0,0 +1,125 @@
+#include "Subgraph.h"
+#include "UFDS.h"
+#include "Stats.h"
+
+Subgraph::Subgraph(const Graph& graph, const vector<Node*>& nodes): graph(graph), nodes(nodes), weights(graph.getPrecision()) {
+    localIndex.reserve(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); i++) localIndex.emplace(nodes[i], i);
+
+    offsets.reserve(nodes.size() + 1);
+    offsets.push_back(0);
+    for (Node* node : nodes) {
+        for (Edge* edge : node->getAdj()) {
+            auto it = localIndex.find(edge->getDest());
+            if (it == localIndex.end()) continue;
+            targets.push_back(it->second);
+            weights.push_back(edge->getWeight());
+            edges.push_back(edge);
+        }
+        offsets.push_back(targets.size());
+    }
+    selected.assign(targets.size(), false);
+}
+
+unsigned int Subgraph::size() const {
+    return nodes.size();
+}
+
+Node* Subgraph::getNode(unsigned int local) const {
+    return nodes[local];
+}
+
+int Subgraph::getLocalIndex(const Node* node) const {
+    auto it = localIndex.find(node);
+    return it == localIndex.end() ? -1 : (int) it->second;
+}
+
+double Subgraph::kruskal() {
+    STATS_PHASE("subgraph/kruskal");
+    UFDS ufds(nodes.size());
+    std::vector<std::pair<unsigned int, unsigned int>> sortedEdges; // (local origin, local edge)
+    selected.assign(targets.size(), false);
+
+    for (unsigned int u = 0; u < nodes.size(); u++) {
+        for (unsigned int e = offsets[u]; e < offsets[u + 1]; e++) {
+            if (u < targets[e]) sortedEdges.emplace_back(u, e);
+        }
+    }
+
+    std::sort(sortedEdges.begin(), sortedEdges.end(), [this](const std::pair<unsigned int, unsigned int>& e1, const std::pair<unsigned int, unsigned int>& e2) {
+        return weights.less(e1.second, e2.second);
+    });
+
+    unsigned selectedEdges = 0;
+    WeightSum totalWeight(graph.getPrecision());
+    for (auto& [u, e] : sortedEdges) {
+        STATS_COUNT(MST_EDGES_SCANNED, 1);
+        unsigned int v = targets[e];
+        if (!ufds.isSameSet(u, v)) {
+            ufds.linkSets(u, v);
+
+            selected[e] = true;
+            for (unsigned int r = offsets[v]; r < offsets[v + 1]; r++) {
+                if (edges[r] == edges[e]->getReverse()) {
+                    selected[r] = true;
+                    break;
+                }
+            }
+            totalWeight.add(weights.get(e));
+
+            if (++selectedEdges == nodes.size() - 1) {
+                break;
+            }
+        }
+    }
+    return totalWeight.value();
+}
+
+std::vector<Edge*> Subgraph::getSelectedEdges() const {
+    std::vector<Edge*> result;
+    for (unsigned int u = 0; u < nodes.size(); u++) {
+        for (unsigned int e = offsets[u]; e < offsets[u + 1]; e++) {
+            if (selected[e] && u < targets[e]) result.push_back(edges[e]);
+        }
+    }
+    return result;
+}
+
+double Subgraph::preOrder(vector<Node*>& tour) const {
+    if (nodes.empty()) return 0;
+    STATS_PHASE("subgraph/preOrder");
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<std::pair<unsigned int, unsigned int>> stack; // (local node, next local edge to look at)
+    Node* first = nullptr, *last = nullptr;
+    WeightSum weight(graph.getPrecision());
+
+    for (unsigned int root = 0; root < nodes.size(); root++) {
+        if (visited[root]) continue;
+        visited[root] = true;
+        stack.emplace_back(root, offsets[root]);
+        Node* rootNode = nodes[root];
+        if (last != nullptr) weight.add(graph.getDistance(last, rootNode));
+        else first = rootNode;
+        tour.push_back(rootNode);
+        last = rootNode;
+        while (!stack.empty()) {
+            auto& [u, e] = stack.back();
+            if (e == offsets[u + 1]) {
+                stack.pop_back();
+                continue;
+            }
+            unsigned int v = targets[e];
+            bool child = selected[e] && !visited[v];
+            e++;
+            if (child) {
+                visited[v] = true;
+                weight.add(graph.getDistance(last, nodes[v]));
+                tour.push_back(nodes[v]);
+                last = nodes[v];
+                stack.emplace_back(v, offsets[v]);
+            }
+        }
+    }
+    weight.add(graph.getDistance(last, first));
+    return weight.value();
+}
@@ -0,0 +1,75 @@
+#ifndef PROJETO_DA_2_SUBGRAPH_H
+#define PROJETO_DA_2_SUBGRAPH_H
+
+#include <unordered_map>
+#include "Graph.h"
+
+class Subgraph {
+public:
+    /**
+     * Constructor of the Subgraph class. Extracts the subgraph induced by the nodes given as parameter, remapping them once
+     * to the local indexes 0..n-1 (in the order of the vector) and copying the edges between them into local arrays, in the
+     * same order as in the adjacency vectors of the nodes, the weights in the storage mode of the graph. Nothing is written
+     * to the nodes or edges of the graph.
+     * @param graph Represents the graph the nodes belong to, used for the distances of edges it does not provide
+     * @param nodes Represents the nodes of the subgraph, e.g. a cluster
+     * @note Time-complexity -> O(n + E) on average with n being the size of the nodes vector and E the number of outgoing edges of those nodes
+     */
+    Subgraph(const Graph& graph, const std::vector<Node*>& nodes);
+    /**
+     * Returns the number of nodes of the (this) subgraph.
+     * @return The number of nodes
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int size() const;
+    /**
+     * Returns the node with the local index given as parameter.
+     * @param local Represents the local index of the node
+     * @return The node
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] Node* getNode(unsigned int local) const;
+    /**
+     * Returns the local index of the node given as parameter.
+     * @param node Represents a node of the graph
+     * @return The local index of the node, -1 if it does not belong to the (this) subgraph
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] int getLocalIndex(const Node* node) const;
+    /**
+     * Implementation of the kruskal algorithm over the local edges. Selects the edges of a minimum spanning forest (a tree
+     * if the subgraph is connected) using a UFDS sized to the subgraph. The edges are sorted by their stored weights, which
+     * are integers with FIXED_POINT storage, and the weights are summed in the storage mode (exactly with FIXED_POINT).
+     * @return The sum of the weight of the selected edges
+     * @note Time-complexity -> O(E*log(E)) with E being the number of local edges
+     */
+    double kruskal();
+    /**
+     * Returns the graph edges selected by the last call of kruskal, one per selected undirected edge.
+     * @return vector&lt Edge*> with the selected edges, oriented from the lower to the higher local index
+     * @note Time-complexity -> O(E) with E being the number of local edges
+     */
+    [[nodiscard]] std::vector<Edge*> getSelectedEdges() const;
+    /**
+     * Visits the forest selected by kruskal in preOrder, starting with local node 0 and going through the children of each
+     * node in adjacency order, like Graph::preOrder. Trees not reachable from node 0 are visited afterwards, each from its
+     * lowest local index. Appends the visited nodes to tour and returns the weight of the hamiltonian cycle they form,
+     * using Graph::getDistance between consecutive nodes and back to the first one.
+     * @param tour Represents the vector to which the nodes are appended
+     * @return The weight of the cycle
+     * @note Time-complexity -> O(n + E) with n being the number of nodes and E the number of local edges, if the edges of the graph are indexed
+     */
+    double preOrder(std::vector<Node*>& tour) const;
+private:
+    const Graph& graph;
+    std::vector<Node*> nodes;
+    std::unordered_map<const Node*, unsigned int> localIndex;
+
+    std::vector<unsigned int> offsets;    // the edges of local node u are in [offsets[u], offsets[u+1])
+    std::vector<unsigned int> targets;    // local index of the destination of each edge
+    WeightArray weights;                  // weight of each edge, in the storage mode of the graph
+    std::vector<Edge*> edges;             // graph edge of each local edge
+    std::vector<bool> selected;           // local edges in the forest selected by kruskal (both directions)
+};
+
+#endif //PROJETO_DA_2_SUBGRAPH_H
@@ -0,0 +1,119 @@
+#ifndef PROJETO_DA_2_THREADPOOL_H
+#define PROJETO_DA_2_THREADPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    /**
+     * Constructor of the ThreadPool class. Starts nThreads worker threads that wait for tasks.
+     * @param nThreads Represents the number of worker threads. Defaults to the number of hardware threads
+     * @note Time-complexity -> O(T) with T being the number of threads
+     */
+    explicit ThreadPool(unsigned int nThreads = std::thread::hardware_concurrency());
+    /**
+     * Destructor of the ThreadPool class. Runs the tasks still queued and joins the worker threads.
+     * @note Time-complexity -> O(T) with T being the number of threads
+     */
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /**
+     * Queues a task to be run by one of the worker threads.
+     * @param task Represents a callable with no parameters
+     * @return A future holding the result of the task
+     * @note Time-complexity -> O(1)
+     */
+    template<typename F>
+    auto submit(F task) -> std::future<decltype(task())>;
+    /**
+     * Waits for the future given as parameter. While it is not ready, the calling thread runs queued tasks, so a
+     * task that waits on tasks it submitted (e.g. a recursion) never blocks a worker that its children need. The newest
+     * task is run first, which is most likely one submitted by the waiting task itself, so the tasks nested on the stack
+     * of a thread follow the recursion instead of piling up with unrelated ones.
+     * @param future Represents the future to wait for
+     * @return The result of the future
+     * @note Time-complexity -> O(1) plus the time of the tasks run while waiting
+     */
+    template<typename T>
+    T wait(std::future<T>& future);
+    /**
+     * Runs body(t) for every t in [0, tasks), spread over the pool, and returns when all of them have finished. The last
+     * task is run on the calling thread.
+     * @param tasks Represents the number of tasks
+     * @param body Represents a callable taking the index of the task
+     * @note Time-complexity -> O(tasks) plus the time of the tasks
+     */
+    template<typename F>
+    void parallelFor(unsigned int tasks, F body);
+    /**
+     * Returns the number of worker threads of the (this) pool.
+     * @return The number of worker threads
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int size() const;
+    /**
+     * Returns the pool shared by the solvers, created on first use with one thread per hardware thread.
+     * @return The shared pool
+     * @note Time-complexity -> O(T) on the first call, O(1) afterwards
+     */
+    static ThreadPool& shared();
+private:
+    /**
+     * Pops the newest queued task, if there is any, and runs it on the calling thread.
+     * @return True if a task was run, false if the queue was empty
+     * @note Time-complexity -> O(1) plus the time of the task
+     */
+    bool runPendingTask();
+    /**
+     * Loop run by each worker thread, which takes tasks from the queue until the pool is destroyed.
+     */
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+};
+
+template<typename F>
+auto ThreadPool::submit(F task) -> std::future<decltype(task())> {
+    auto packaged = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+    auto future = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace_back([packaged]() { (*packaged)(); });
+    }
+    condition.notify_one();
+    return future;
+}
+
+template<typename T>
+T ThreadPool::wait(std::future<T>& future) {
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!runPendingTask()) future.wait_for(std::chrono::microseconds(50));
+    }
+    return future.get();
+}
+
+template<typename F>
+void ThreadPool::parallelFor(unsigned int tasks, F body) {
+    if (tasks == 0) return;
+    std::vector<std::future<void>> futures;
+    for (unsigned int t = 0; t + 1 < tasks; t++) {
+        futures.push_back(submit([&body, t]() { body(t); }));
+    }
+    body(tasks - 1);
+    for (auto& future : futures) wait(future);
+}
+
+#endif //PROJETO_DA_2_THREADPOOL_H
@@ -0,0 +1,309 @@
+#include "Tour.h"
+#include <algorithm>
+#include <cmath>
+
+Tour::Tour(const Graph& graph, const std::vector<Node*>& tour, bool allowTwoLevel): graph(&graph), nodes(tour), allowTwoLevel(allowTwoLevel) {
+    if (nodes.size() > 1 && nodes.front() == nodes.back()) nodes.pop_back();
+    unsigned int n = nodes.size();
+    local = std::make_shared<std::unordered_map<const Node*, unsigned int>>();
+    for (unsigned int i = 0; i < n; i++) local->emplace(nodes[i], i);
+    for (unsigned int i = 0; i < n && n > 1; i++) cost += graph.getDistance(nodes[i], nodes[(i + 1) % n]);
+
+    twoLevel = false;
+    order.resize(n);
+    pos.resize(n);
+    for (unsigned int i = 0; i < n; i++) order[i] = pos[i] = i;
+    if (allowTwoLevel && n >= TWO_LEVEL_MIN) makeTwoLevel(order);
+}
+
+unsigned int Tour::size() const {
+    return nodes.size();
+}
+
+double Tour::getCost() const {
+    return cost;
+}
+
+bool Tour::isTwoLevel() const {
+    return twoLevel;
+}
+
+bool Tour::contains(Node* node) const {
+    return local->count(node) != 0;
+}
+
+unsigned int Tour::index(Node* node) const {
+    return local->at(node);
+}
+
+unsigned int Tour::position(unsigned int v) const {
+    if (!twoLevel) return pos[v];
+    const Segment& segment = segments[segmentOf[v]];
+    return segment.start + (segment.reversed ? segment.nodes.size() - 1 - offset[v] : offset[v]);
+}
+
+unsigned int Tour::at(unsigned int p) const {
+    if (!twoLevel) return order[p];
+    // the last segment starting at or before p
+    auto it = std::upper_bound(segmentOrder.begin(), segmentOrder.end(), p,
+                               [this](unsigned int p, unsigned int s) { return p < segments[s].start; });
+    const Segment& segment = segments[*(it - 1)];
+    unsigned int k = p - segment.start;
+    return segment.nodes[segment.reversed ? segment.nodes.size() - 1 - k : k];
+}
+
+unsigned int Tour::nextIndex(unsigned int v) const {
+    unsigned int n = nodes.size();
+    if (!twoLevel) return order[(pos[v] + 1) % n];
+    const Segment& segment = segments[segmentOf[v]];
+    unsigned int last = segment.nodes.size() - 1;
+    if (segment.reversed ? offset[v] > 0 : offset[v] < last) return segment.nodes[segment.reversed ? offset[v] - 1 : offset[v] + 1];
+    const Segment& following = segments[segmentOrder[(segment.rank + 1) % segmentOrder.size()]];
+    return following.reversed ? following.nodes.back() : following.nodes.front();
+}
+
+unsigned int Tour::prevIndex(unsigned int v) const {
+    unsigned int n = nodes.size();
+    if (!twoLevel) return order[(pos[v] + n - 1) % n];
+    const Segment& segment = segments[segmentOf[v]];
+    unsigned int last = segment.nodes.size() - 1;
+    if (segment.reversed ? offset[v] < last : offset[v] > 0) return segment.nodes[segment.reversed ? offset[v] + 1 : offset[v] - 1];
+    const Segment& preceding = segments[segmentOrder[(segment.rank + segmentOrder.size() - 1) % segmentOrder.size()]];
+    return preceding.reversed ? preceding.nodes.front() : preceding.nodes.back();
+}
+
+Node* Tour::next(Node* node) const {
+    return nodes[nextIndex(index(node))];
+}
+
+Node* Tour::prev(Node* node) const {
+    return nodes[prevIndex(index(node))];
+}
+
+bool Tour::between(Node* a, Node* b, Node* c) const {
+    unsigned int pa = position(index(a)), pb = position(index(b)), pc = position(index(c));
+    if (pa <= pc) return pa <= pb && pb <= pc;
+    return pb >= pa || pb <= pc;
+}
+
+void Tour::reverse(Node* from, Node* to) {
+    reverseIndex(index(from), index(to));
+}
+
+void Tour::reverse(Node* before, Node* from, Node* to) {
+    reverseIndex(index(before), index(from), index(to));
+}
+
+void Tour::reverseIndex(unsigned int before, unsigned int from, unsigned int to) {
+    if (nextIndex(before) == from) reverseIndex(from, to);
+    else reverseIndex(to, from);
+}
+
+void Tour::reverseIndex(unsigned int f, unsigned int t) {
+    unsigned int n = nodes.size();
+    unsigned int pf = position(f), pt = position(t);
+    unsigned int length = (pt + n - pf) % n + 1;
+    if (length >= n - 1) return;    // the whole cycle, or all of it but one node: the same cycle walked the other way round
+
+    unsigned int a = prevIndex(f), b = nextIndex(t);
+    cost += graph->getDistance(nodes[a], nodes[t]) + graph->getDistance(nodes[f], nodes[b])
+            - graph->getDistance(nodes[a], nodes[f]) - graph->getDistance(nodes[t], nodes[b]);
+
+    if (!twoLevel) {
+        // reverses the shorter of the path and the rest of the tour, wrapping around the end of the array
+        unsigned int i = pf, j = pt;
+        if (2 * length > n) {
+            i = (pt + 1) % n;
+            j = (pf + n - 1) % n;
+            length = n - length;
+        }
+        for (unsigned int k = 0; k < length / 2; k++) {
+            unsigned int x = (i + k) % n, y = (j + n - k) % n;
+            std::swap(order[x], order[y]);
+            pos[order[x]] = x;
+            pos[order[y]] = y;
+        }
+        return;
+    }
+    // a path that wraps around position 0 is replaced by the rest of the tour, which does not
+    if (pf <= pt) reversePositions(pf, pt);
+    else reversePositions(pt + 1, pf - 1);
+}
+
+void Tour::reversePositions(unsigned int i, unsigned int j) {
+    split(i);
+    split(j + 1);
+    unsigned int first = segments[segmentOf[at(i)]].rank, last = segments[segmentOf[at(j)]].rank;
+    std::reverse(segmentOrder.begin() + first, segmentOrder.begin() + last + 1);
+    for (unsigned int r = first; r <= last; r++) segments[segmentOrder[r]].reversed ^= true;
+    renumber(first);
+    if (segmentOrder.size() > 2 * ((nodes.size() + segmentSize - 1) / segmentSize)) rebalance();
+}
+
+void Tour::split(unsigned int p) {
+    if (p == 0 || p >= nodes.size()) return;
+    unsigned int s = segmentOf[at(p)];
+    unsigned int k = p - segments[s].start;
+    if (k == 0) return;
+
+    // both halves are rebuilt in tour order, so they start out not reversed
+    Segment& segment = segments[s];
+    std::vector<unsigned int> walk(segment.nodes);
+    if (segment.reversed) std::reverse(walk.begin(), walk.end());
+    Segment tail;
+    tail.nodes.assign(walk.begin() + k, walk.end());
+    segment.nodes.assign(walk.begin(), walk.begin() + k);
+    segment.reversed = false;
+    unsigned int rank = segment.rank, t = segments.size();
+    for (unsigned int o = 0; o < segment.nodes.size(); o++) offset[segment.nodes[o]] = o;
+    for (unsigned int o = 0; o < tail.nodes.size(); o++) {
+        segmentOf[tail.nodes[o]] = t;
+        offset[tail.nodes[o]] = o;
+    }
+    segments.push_back(std::move(tail));
+    segmentOrder.insert(segmentOrder.begin() + rank + 1, t);
+    renumber(rank);
+}
+
+void Tour::renumber(unsigned int fromRank) {
+    unsigned int start = 0;
+    if (fromRank > 0) {
+        const Segment& preceding = segments[segmentOrder[fromRank - 1]];
+        start = preceding.start + preceding.nodes.size();
+    }
+    for (unsigned int r = fromRank; r < segmentOrder.size(); r++) {
+        Segment& segment = segments[segmentOrder[r]];
+        segment.rank = r;
+        segment.start = start;
+        start += segment.nodes.size();
+    }
+}
+
+void Tour::insertAfter(Node* after, Node* node) {
+    unsigned int n = nodes.size();
+    unsigned int a = index(after), b = nextIndex(a), v = n;
+    cost += graph->getDistance(after, node) + graph->getDistance(node, nodes[b]) - graph->getDistance(after, nodes[b]);
+    nodes.push_back(node);
+    ownLookup().emplace(node, v);
+
+    if (!twoLevel) {
+        unsigned int p = pos[a] + 1;
+        order.insert(order.begin() + p, v);
+        pos.push_back(p);
+        for (unsigned int i = p + 1; i <= n; i++) pos[order[i]] = i;
+        if (allowTwoLevel && n + 1 >= TWO_LEVEL_MIN) makeTwoLevel(order);
+        return;
+    }
+    // a reversed segment is walked from the back, so the node goes before a in its vector
+    unsigned int s = segmentOf[a];
+    Segment& segment = segments[s];
+    unsigned int o = segment.reversed ? offset[a] : offset[a] + 1;
+    segment.nodes.insert(segment.nodes.begin() + o, v);
+    segmentOf.push_back(s);
+    offset.push_back(o);
+    for (unsigned int k = o + 1; k < segment.nodes.size(); k++) offset[segment.nodes[k]] = k;
+    renumber(segment.rank);
+    if (segment.nodes.size() > 2 * segmentSize) split(segment.start + segment.nodes.size() / 2);
+    if (4 * segmentSize * segmentSize < nodes.size()
+        || segmentOrder.size() > 2 * ((nodes.size() + segmentSize - 1) / segmentSize)) rebalance();
+}
+
+void Tour::erase(Node* node) {
+    unsigned int v = index(node), last = nodes.size() - 1;
+    if (nodes.size() > 1) {
+        Node* before = nodes[prevIndex(v)], *after = nodes[nextIndex(v)];
+        cost += graph->getDistance(before, after) - graph->getDistance(before, node) - graph->getDistance(node, after);
+    }
+    ownLookup().erase(node);
+
+    if (!twoLevel) {
+        order.erase(order.begin() + pos[v]);
+        for (unsigned int i = pos[v]; i < order.size(); i++) pos[order[i]] = i;
+    } else {
+        Segment& segment = segments[segmentOf[v]];
+        segment.nodes.erase(segment.nodes.begin() + offset[v]);
+        for (unsigned int k = offset[v]; k < segment.nodes.size(); k++) offset[segment.nodes[k]] = k;
+        // an empty segment leaves the order, and stays unused in segments until the next rebalance
+        unsigned int rank = segment.rank;
+        if (segment.nodes.empty()) segmentOrder.erase(segmentOrder.begin() + rank);
+        renumber(rank);
+    }
+
+    // the last index takes the place of v
+    if (v != last) {
+        nodes[v] = nodes[last];
+        (*local)[nodes[v]] = v;
+        if (!twoLevel) {
+            order[pos[last]] = v;
+            pos[v] = pos[last];
+        } else {
+            segments[segmentOf[last]].nodes[offset[last]] = v;
+            segmentOf[v] = segmentOf[last];
+            offset[v] = offset[last];
+        }
+    }
+    nodes.pop_back();
+    if (!twoLevel) {
+        pos.pop_back();
+    } else {
+        segmentOf.pop_back();
+        offset.pop_back();
+    }
+}
+
+void Tour::makeTwoLevel(std::vector<unsigned int> walk) {
+    twoLevel = true;
+    order.clear();
+    pos.clear();
+    segmentOf.resize(nodes.size());
+    offset.resize(nodes.size());
+    segments.clear();
+    segments.push_back({});
+    segments[0].nodes = std::move(walk);
+    segmentOrder = {0};
+    rebalance();
+}
+
+std::unordered_map<const Node*, unsigned int>& Tour::ownLookup() {
+    if (local.use_count() > 1) local = std::make_shared<std::unordered_map<const Node*, unsigned int>>(*local);
+    return *local;
+}
+
+void Tour::rebalance() {
+    unsigned int n = nodes.size();
+    std::vector<unsigned int> walk;
+    walk.reserve(n);
+    for (unsigned int s : segmentOrder) {
+        const Segment& segment = segments[s];
+        if (segment.reversed) walk.insert(walk.end(), segment.nodes.rbegin(), segment.nodes.rend());
+        else walk.insert(walk.end(), segment.nodes.begin(), segment.nodes.end());
+    }
+
+    segmentSize = std::max(1u, (unsigned int) std::sqrt((double) n));
+    segments.clear();
+    segmentOrder.clear();
+    for (unsigned int p = 0; p < n; p += segmentSize) {
+        Segment segment;
+        segment.nodes.assign(walk.begin() + p, walk.begin() + std::min(n, p + segmentSize));
+        for (unsigned int o = 0; o < segment.nodes.size(); o++) {
+            segmentOf[segment.nodes[o]] = segments.size();
+            offset[segment.nodes[o]] = o;
+        }
+        segmentOrder.push_back(segments.size());
+        segments.push_back(std::move(segment));
+    }
+    renumber(0);
+}
+
+std::vector<Node*> Tour::toVector(Node* start) const {
+    std::vector<Node*> tour;
+    if (nodes.empty()) return tour;
+    unsigned int first = start != nullptr ? index(start) : 0;
+    unsigned int v = first;
+    do {
+        tour.push_back(nodes[v]);
+        v = nextIndex(v);
+    } while (v != first);
+    tour.push_back(nodes[first]);
+    return tour;
+}
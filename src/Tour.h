@@ -0,0 +1,185 @@
+#ifndef PROJETO_DA_2_TOUR_H
+#define PROJETO_DA_2_TOUR_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * Hamiltonian cycle over a set of nodes, with its cost, supporting the queries and the reversals of move-based optimizers
+ * (2-opt, Or-opt, Lin-Kernighan) without rebuilding a vector. Up to TWO_LEVEL_MIN nodes the tour is an order array plus
+ * the position of each node, so queries are O(1) and reversals O(n). From TWO_LEVEL_MIN nodes on it is a two-level list:
+ * the cycle is split into about sqrt(n) segments, each one with a reversed bit, so a reversal only splits the two
+ * segments at its ends and flips the order of the segments between them, in O(sqrt(n)). Nodes can be inserted and erased
+ * in place, at the cost of a reversal. Every node can also be given by its index in the vector the tour was built with,
+ * which skips looking it up. Copies share the lookup of the nodes until one of them inserts or erases a node.
+ */
+class Tour {
+public:
+    static const unsigned int TWO_LEVEL_MIN = 1000;
+
+    /**
+     * Constructor of the Tour class, from the vector form used by printPath.
+     * @param graph Represents the graph the nodes belong to, whose getDistance gives the cost of the tour
+     * @param nodes Represents the nodes in visiting order, closed (ending with the first node) or not
+     * @param allowTwoLevel Represents if the tour becomes a two-level list from TWO_LEVEL_MIN nodes on, also once it grows
+     * to that size through insertAfter. If false it stays an array at any size, for callers that copy the tour as often as
+     * they reverse it
+     * @note Time-complexity -> O(n) with n being the number of nodes
+     */
+    Tour(const Graph& graph, const std::vector<Node*>& nodes, bool allowTwoLevel = true);
+    /**
+     * Returns the number of nodes of the (this) tour.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int size() const;
+    /**
+     * Returns the cost of the (this) tour, kept up to date by reverse.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double getCost() const;
+    /**
+     * Checks if the (this) tour is a two-level list.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] bool isTwoLevel() const;
+    /**
+     * Checks if the node given as parameter is in the (this) tour.
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] bool contains(Node* node) const;
+    /**
+     * Returns the index of the node given as parameter in the vector the tour was built with.
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] unsigned int index(Node* node) const;
+    /**
+     * Returns the node after the node given as parameter.
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] Node* next(Node* node) const;
+    /**
+     * Returns the index of the node after the node of index v.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int nextIndex(unsigned int v) const;
+    /**
+     * Returns the node before the node given as parameter.
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] Node* prev(Node* node) const;
+    /**
+     * Returns the index of the node before the node of index v.
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] unsigned int prevIndex(unsigned int v) const;
+    /**
+     * Checks if b is on the path that goes forward from a to c, both included.
+     * @note Time-complexity -> O(1) on average
+     */
+    [[nodiscard]] bool between(Node* a, Node* b, Node* c) const;
+    /**
+     * Reverses the path that goes forward from the node from to the node to, i.e. replaces the edges (prev(from), from)
+     * and (to, next(to)) with (prev(from), to) and (from, next(to)), and updates the cost. The rest of the tour may be
+     * reversed instead when it is shorter, which gives the same cycle walked the other way round, so next and prev must
+     * be asked again after a reversal.
+     * @note Time-complexity -> O(n) as an array, O(sqrt(n)) amortized as a two-level list
+     */
+    void reverse(Node* from, Node* to);
+    /**
+     * Reverses the path from the node from to the node to that starts next to the node before, whichever way round the
+     * tour is walked, i.e. replaces the edges (before, from) and (to, after) with (before, to) and (from, after). Unlike
+     * reverse(from, to), a sequence of these needs no next or prev in between.
+     * @note Time-complexity -> as reverse(from, to)
+     */
+    void reverse(Node* before, Node* from, Node* to);
+    /**
+     * The two reversals above, with the nodes given by their indices.
+     */
+    void reverseIndex(unsigned int from, unsigned int to);
+    void reverseIndex(unsigned int before, unsigned int from, unsigned int to);
+    /**
+     * Inserts the node given as parameter, which must not be in the (this) tour, between the node after and the node next
+     * to it, and updates the cost. The new node takes the index after the last one.
+     * @param after Represents the node of the tour the new node follows
+     * @param node Represents the node to be inserted
+     * @note Time-complexity -> O(n) as an array, O(sqrt(n)) amortized as a two-level list
+     */
+    void insertAfter(Node* after, Node* node);
+    /**
+     * Removes the node given as parameter from the (this) tour, connecting the nodes before and after it, and updates the
+     * cost. The node with the last index takes over the index of the removed one.
+     * @param node Represents the node to be removed, which must be in the tour
+     * @note Time-complexity -> as insertAfter
+     */
+    void erase(Node* node);
+    /**
+     * Returns the (this) tour in the vector form used by printPath: closed, starting and ending at the node given as
+     * parameter.
+     * @param start Represents the first node. If nullptr, the first node the tour was built with is used
+     * @note Time-complexity -> O(n)
+     */
+    [[nodiscard]] std::vector<Node*> toVector(Node* start = nullptr) const;
+
+private:
+    /**
+     * Run of consecutive nodes of a two-level list. If reversed, the nodes are walked from the back of the vector.
+     */
+    struct Segment {
+        std::vector<unsigned int> nodes;
+        bool reversed = false;
+        unsigned int rank = 0;      // position of the segment in order
+        unsigned int start = 0;     // position in the tour of its first node
+    };
+
+    /**
+     * Returns the position of node v in the tour, from 0 to size()-1.
+     */
+    [[nodiscard]] unsigned int position(unsigned int v) const;
+    /**
+     * Returns the node at position p of the tour.
+     */
+    [[nodiscard]] unsigned int at(unsigned int p) const;
+    /**
+     * Reverses the positions i to j, with i <= j.
+     */
+    void reversePositions(unsigned int i, unsigned int j);
+    /**
+     * Makes position p the first one of a segment, splitting the segment that holds it.
+     */
+    void split(unsigned int p);
+    /**
+     * Updates the rank and start of the segments from the rank given on.
+     */
+    void renumber(unsigned int fromRank);
+    /**
+     * Rebuilds the segments with about sqrt(n) nodes each, once splits have made too many.
+     */
+    void rebalance();
+    /**
+     * Turns the (this) tour into a two-level list of the nodes of the given indices, in tour order.
+     */
+    void makeTwoLevel(std::vector<unsigned int> walk);
+    /**
+     * Returns the lookup of the nodes, copying it first if it is shared with other tours.
+     */
+    std::unordered_map<const Node*, unsigned int>& ownLookup();
+
+    const Graph* graph;
+    std::vector<Node*> nodes;
+    std::shared_ptr<std::unordered_map<const Node*, unsigned int>> local;    // index of each node in nodes
+    double cost = 0;
+    bool allowTwoLevel, twoLevel;
+
+    // array
+    std::vector<unsigned int> order, pos;
+
+    // two-level list
+    std::vector<Segment> segments;
+    std::vector<unsigned int> segmentOrder;     // segments in tour order
+    std::vector<unsigned int> segmentOf, offset;   // segment of each node and its index in the vector of the segment
+    unsigned int segmentSize = 0;
+};
+
+#endif //PROJETO_DA_2_TOUR_H
@@ -0,0 +1,174 @@
+#include "TourRepair.h"
+#include <cmath>
+
+static const unsigned int MAX_REPAIR_PASSES = 8;
+static const unsigned int INSERTION_CANDIDATES = 8;
+static const unsigned int MIN_STALE_STOPS = 64;
+static const double EPSILON = 1e-9;
+
+TourRepair::TourRepair(Graph& graph, const vector<Node*>& tour, double weight, unsigned int window):
+    graph(graph), tour(graph, tour), depot(tour.empty() ? nullptr : tour.front()), weight(weight), window(window) {
+    if (!graph.isNodeIndexed()) graph.indexNodes();
+    if (!graph.isEdgeIndexed()) graph.indexEdges();
+    rebuildTree();
+}
+
+void TourRepair::rebuildTree() {
+    indexed = tour.toVector();
+    if (!indexed.empty()) indexed.pop_back();
+    // sorted by address, so a removed stop is found by a binary search
+    std::sort(indexed.begin(), indexed.end());
+    alive.assign(indexed.size(), true);
+    tree = std::make_unique<KdTree>(indexed, graph.getPrecision().getStorage());
+    added.clear();
+    removed = 0;
+}
+
+vector<Node*> TourRepair::getTour() const {
+    vector<Node*> closed = tour.toVector(depot);
+    if (backward) std::reverse(closed.begin(), closed.end());
+    return closed;
+}
+
+double TourRepair::getWeight() const {
+    return weight;
+}
+
+double TourRepair::insertStop(int id, double longitude, double latitude, const vector<pair<int, double>>& edges) {
+    if (!graph.addNode(id, longitude, latitude)) return -1;
+    Node* node = graph.findNode(id);
+    for (auto& [dest, w] : edges) {
+        if (graph.addBidirectionalEdge(id, dest, w)) graph.findNode(dest)->sortEdges();
+    }
+    node->sortEdges();
+
+    if (tour.size() == 0) {
+        tour = Tour(graph, {node});
+        depot = node;
+        backward = false;
+        rebuildTree();
+        return weight = 0;
+    }
+    if (added.size() + removed > std::max(MIN_STALE_STOPS, (unsigned int) std::sqrt((double) tour.size()))) rebuildTree();
+
+    // the stops removed since the tree was built may be among the nearest ones, so as many more are asked for
+    vector<Node*> candidates = added;
+    for (unsigned int i : tree->nearest(longitude, latitude, INSERTION_CANDIDATES + removed)) {
+        if (alive[i]) candidates.push_back(indexed[i]);
+    }
+    for (auto& [dest, w] : edges) {
+        Node* other = graph.findNode(dest);
+        if (other != nullptr && tour.contains(other)) candidates.push_back(other);
+    }
+    if (candidates.empty()) candidates.push_back(depot);
+
+    // the edges of the tour on both sides of each candidate
+    Node* bestAfter = nullptr;
+    double bestDelta = INF;
+    for (Node* c : candidates) {
+        for (Node* a : {tour.prev(c), c}) {
+            Node* b = tour.next(a);
+            double delta = graph.getDistance(a, node) + graph.getDistance(node, b) - graph.getDistance(a, b);
+            if (delta < bestDelta) {
+                bestDelta = delta;
+                bestAfter = a;
+            }
+        }
+    }
+    tour.insertAfter(bestAfter, node);
+    added.push_back(node);
+    weight += bestDelta;
+    repair(node);
+    return weight;
+}
+
+double TourRepair::removeStop(int id) {
+    Node* node = graph.findNode(id);
+    if (node == nullptr || node == depot || !tour.contains(node)) return -1;
+
+    Node* before = backward ? tour.next(node) : tour.prev(node), *after = backward ? tour.prev(node) : tour.next(node);
+    weight += graph.getDistance(before, after) - graph.getDistance(before, node) - graph.getDistance(node, after);
+    tour.erase(node);
+    auto it = std::lower_bound(indexed.begin(), indexed.end(), node);
+    if (it != indexed.end() && *it == node) {
+        alive[it - indexed.begin()] = false;
+        removed++;
+    } else {
+        added.erase(std::find(added.begin(), added.end(), node));
+    }
+    graph.removeNode(id);
+    if (tour.size() > 1) repair(before);
+    return weight;
+}
+
+void TourRepair::repair(Node* around) {
+    if (tour.size() < 4) return;
+    auto succ = [&](Node* v) { return backward ? tour.prev(v) : tour.next(v); };
+    auto pred = [&](Node* v) { return backward ? tour.next(v) : tour.prev(v); };
+    // the moves only rearrange path[1..m], between path[0] and path[m+1], which the depot is never inside of
+    Node* from = around == depot ? succ(depot) : around, *to = from;
+    for (unsigned int k = 0; k < window && pred(from) != depot; k++) from = pred(from);
+    for (unsigned int k = around == depot ? 1 : 0; k < window && succ(to) != depot; k++) to = succ(to);
+    vector<Node*> path = {pred(from), from};
+    while (path.back() != to) path.push_back(succ(path.back()));
+    path.push_back(succ(to));
+    unsigned int m = path.size() - 2;
+
+    auto dist = [&](unsigned int i, unsigned int j) { return graph.getDistance(path[i], path[j]); };
+    // reverses path[i..j] both in the tour and in path
+    auto flip = [&](unsigned int i, unsigned int j) {
+        tour.reverse(path[i - 1], path[i], path[j]);
+        std::reverse(path.begin() + i, path.begin() + j + 1);
+    };
+
+    bool improved = true;
+    for (unsigned int pass = 0; improved && pass < MAX_REPAIR_PASSES; pass++) {
+        improved = false;
+
+        // 2-opt: replace (i-1, i) and (j, j+1) by (i-1, j) and (i, j+1), reversing path[i..j]
+        for (unsigned int i = 1; i <= m; i++) {
+            for (unsigned int j = i + 1; j <= m; j++) {
+                double delta = dist(i - 1, j) + dist(i, j + 1) - dist(i - 1, i) - dist(j, j + 1);
+                if (delta < -EPSILON) {
+                    flip(i, j);
+                    weight += delta;
+                    improved = true;
+                }
+            }
+        }
+
+        // or-opt: move path[i..i+len-1] between path[k] and path[k+1], in either orientation
+        for (unsigned int len = 1; len <= 3; len++) {
+            for (unsigned int i = 1; i + len - 1 <= m; i++) {
+                unsigned int last = i + len - 1;
+                double removed = dist(i - 1, i) + dist(last, last + 1) - dist(i - 1, last + 1);
+                for (unsigned int k = 0; k <= m; k++) {
+                    if (k + 1 >= i && k <= last) continue;
+                    double kept = dist(k, k + 1);
+                    double forward = dist(k, i) + dist(last, k + 1) - kept;
+                    double backward = dist(k, last) + dist(i, k + 1) - kept;
+                    double delta = std::min(forward, backward) - removed;
+                    if (delta >= -EPSILON) continue;
+
+                    // S A -> A' S' -> A S', or B S -> S' B' -> S' B, leaving the segment reversed
+                    unsigned int first;
+                    if (k > last) {
+                        flip(i, k);
+                        flip(i, i + k - last - 1);
+                        first = k + 1 - len;
+                    } else {
+                        flip(k + 1, last);
+                        flip(k + 1 + len, last);
+                        first = k + 1;
+                    }
+                    if (forward <= backward) flip(first, first + len - 1);
+                    weight += delta;
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+    // the reversals of the tour may have walked it the other way round, while path kept the order of the vector form
+    backward = tour.next(path[0]) != path[1];
+}
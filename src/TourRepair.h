@@ -0,0 +1,85 @@
+#ifndef PROJETO_DA_2_TOURREPAIR_H
+#define PROJETO_DA_2_TOURREPAIR_H
+
+#include <memory>
+#include "Graph.h"
+#include "KdTree.h"
+#include "Tour.h"
+
+class TourRepair {
+public:
+    /**
+     * Constructor of the TourRepair class. Takes over a tour already solved on the graph, so that stops can be added to or
+     * removed from both without solving again. Builds the node and edge indexes of the graph if they are not up to date,
+     * and a KdTree over the stops of the tour.
+     * @param graph Represents the graph the tour was solved on
+     * @param tour Represents the solved tour, starting at the depot, closed or not
+     * @param weight Represents the weight of the tour
+     * @param window Represents how many positions on each side of a change the local repair may touch
+     * @note Time-complexity -> O(n*log(n)) with n being the size of the tour, plus O(V+E) if the graph is not indexed
+     */
+    TourRepair(Graph& graph, const std::vector<Node*>& tour, double weight, unsigned int window = 16);
+    /**
+     * Adds a new stop to the graph and to the tour. The stop is inserted where it increases the weight of the tour the
+     * least (cheapest insertion) next to one of its candidate stops: the nearest ones by coordinates, the ones it is given
+     * an edge to and the ones added since the KdTree was last built. The tour is then repaired around it.
+     * @param id Represents the id of the new node
+     * @param longitude Represents the longitude of the new node
+     * @param latitude Represents the latitude of the new node
+     * @param edges Represents the (destination id, weight) pairs of the edges of the new node, if any
+     * @return The new weight of the tour, or -1 if a node with that id already exists
+     * @note Time-complexity -> O(sqrt(n)*log(n) + W^2 + D*log(D)) amortized with n being the size of the tour, W the window
+     * and D the degree of the nodes the new one has edges to, the KdTree being rebuilt after about sqrt(n) changes
+     */
+    double insertStop(int id, double longitude, double latitude, const std::vector<std::pair<int, double>>& edges = {});
+    /**
+     * Removes a stop from the tour, connecting its two neighbours, and from the graph, and then repairs the tour around
+     * the gap. The depot (the first node of the tour) cannot be removed.
+     * @param id Represents the id of the node to be removed
+     * @return The new weight of the tour, or -1 if the node is not in the tour or is the depot
+     * @note Time-complexity -> O(sqrt(n) + W^2) amortized with n being the size of the tour and W the window, plus the
+     * removal of the node from the graph (Graph::removeNode)
+     */
+    double removeStop(int id);
+    /**
+     * Returns the current tour, closed with the depot, in the format used by printPath.
+     * @return vector with the nodes of the tour
+     * @note Time-complexity -> O(n) with n being the size of the tour
+     */
+    [[nodiscard]] std::vector<Node*> getTour() const;
+    /**
+     * Returns the weight of the current tour.
+     * @return The weight of the tour
+     * @note Time-complexity -> O(1)
+     */
+    [[nodiscard]] double getWeight() const;
+private:
+    /**
+     * Runs 2-opt and or-opt moves on the nodes within the window around the node given, applying improving moves until
+     * none is left or a fixed number of passes is reached, and updates the weight with their deltas. The depot is never
+     * moved.
+     * @param around Represents the node of the change in the tour, or the node before it
+     * @note Time-complexity -> O(W^2) per pass with W being the window
+     */
+    void repair(Node* around);
+    /**
+     * Builds the KdTree again over the stops of the tour.
+     * @note Time-complexity -> O(n*log(n)) with n being the size of the tour
+     */
+    void rebuildTree();
+
+    Graph& graph;
+    Tour tour;
+    Node* depot;    // first node of the tour, which getTour starts from
+    bool backward = false;  // if tour is walked the other way round from the order getTour returns
+    double weight;
+    unsigned int window;
+
+    std::vector<Node*> indexed;     // stops the tree was built over, by address
+    std::vector<bool> alive;        // if each stop of indexed is still in the tour
+    std::unique_ptr<KdTree> tree;
+    std::vector<Node*> added;       // stops inserted since the tree was built
+    unsigned int removed = 0;       // stops of indexed removed since the tree was built
+};
+
+#endif //PROJETO_DA_2_TOURREPAIR_H
@@ -0,0 +1,67 @@
+#include "TourStitcher.h"
+#include "KdTree.h"
+#include "Stats.h"
+
+TourStitcher::TourStitcher(const Graph& graph, unsigned int candidates): graph(graph), candidates(candidates) {}
+
+double TourStitcher::join(vector<Node*>& solved, double solvedWeight, vector<Node*>& add, double addWeight) const {
+    if (add.empty()) return solvedWeight;
+    if (solved.empty()) {
+        solved.swap(add);
+        return addWeight;
+    }
+    STATS_PHASE("stitch");
+
+    if (solved.size() != 1 && solved.front() == solved.back()) solved.pop_back();
+    if (add.size() != 1 && add.front() == add.back()) add.pop_back();
+
+    unsigned int sSize = solved.size(), aSize = add.size();
+    bool indexSolved = sSize <= aSize;
+    const vector<Node*>& indexed = indexSolved ? solved : add;
+    const vector<Node*>& queried = indexSolved ? add : solved;
+    KdTree tree(indexed, graph.getPrecision().getStorage());
+
+    // Removes the edges (solved[p], solved[p+1]) and (add[x], add[x+1]), and reconnects solved[p] to add[x+1] and add[x]
+    // to solved[p+1] (forward) or solved[p] to add[x] and add[x+1] to solved[p+1] (backward).
+    double bestDelta = INF;
+    unsigned int bestP = 0, bestX = 0;
+    bool bestForward = true;
+    auto evaluate = [&](unsigned int p, unsigned int x) {
+        Node* sp = solved[p], *sn = solved[(p + 1) % sSize];
+        Node* ax = add[x], *ay = add[(x + 1) % aSize];
+        double removed = graph.getDistance(sp, sn) + graph.getDistance(ax, ay);
+        double forward = graph.getDistance(sp, ay) + graph.getDistance(ax, sn) - removed;
+        double backward = graph.getDistance(sp, ax) + graph.getDistance(ay, sn) - removed;
+        if (forward < bestDelta) {
+            bestDelta = forward;
+            bestP = p, bestX = x, bestForward = true;
+        }
+        if (backward < bestDelta) {
+            bestDelta = backward;
+            bestP = p, bestX = x, bestForward = false;
+        }
+    };
+
+    for (unsigned int q = 0; q < queried.size(); q++) {
+        for (unsigned int t : tree.nearest(queried[q]->getLon(), queried[q]->getLat(), candidates)) {
+            unsigned int i = indexSolved ? t : q, j = indexSolved ? q : t;
+            unsigned int prevI = (i + sSize - 1) % sSize, prevJ = (j + aSize - 1) % aSize;
+            evaluate(i, j);
+            evaluate(i, prevJ);
+            evaluate(prevI, j);
+            evaluate(prevI, prevJ);
+        }
+    }
+
+    unsigned int first = (bestX + 1) % aSize;
+    if (!bestForward) {
+        std::reverse(add.begin(), add.end());
+        first = aSize - 1 - bestX;
+    }
+    std::rotate(add.begin(), add.begin() + first, add.end());
+    // copies add and shifts the tail of solved, O(S + A) like the queries
+    solved.insert(solved.begin() + bestP + 1, add.begin(), add.end());
+    add.clear();
+
+    return solvedWeight + addWeight + bestDelta;
+}
@@ -0,0 +1,33 @@
+#ifndef PROJETO_DA_2_TOURSTITCHER_H
+#define PROJETO_DA_2_TOURSTITCHER_H
+
+#include "Graph.h"
+
+class TourStitcher {
+public:
+    /**
+     * Constructor of the TourStitcher class.
+     * @param graph Represents the graph whose distances (Graph::getDistance) are used to cost the joins
+     * @param candidates Represents how many of the closest nodes of the other tour are tried for each node
+     * @note Time-complexity -> O(1)
+     */
+    explicit TourStitcher(const Graph& graph, unsigned int candidates = 5);
+    /**
+     * Joins two solved hamiltonian cycles into one. Candidate connection points are found with a KdTree built over the
+     * smaller tour, and for each candidate pair both orientations of the splice are costed with O(1) deltas. The add tour
+     * is then rotated in place and copied into the solved tour after the chosen node, which shifts the rest of solved, so
+     * the splice itself is O(S + A).
+     * @param solved Represents one of the tours to be merged. At the end of the function call, represents the merged tour
+     * @param solvedWeight Represents the weight of the solved tour
+     * @param add Represents one of the tours to be merged. Its nodes are moved into solved and it is left empty
+     * @param addWeight Represents the weight of the add tour
+     * @return The weight of the merged tour
+     * @note Time-complexity -> O((S + A) * log(min(S, A))) with S being the size of solved and A the size of add
+     */
+    double join(std::vector<Node*>& solved, double solvedWeight, std::vector<Node*>& add, double addWeight) const;
+private:
+    const Graph& graph;
+    unsigned int candidates;
+};
+
+#endif //PROJETO_DA_2_TOURSTITCHER_H
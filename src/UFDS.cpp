@@ -1,4 +1,5 @@
 #include "UFDS.h"
+#include <utility>
 
 UFDS::UFDS(unsigned int N) {
     path.resize(N);
@@ -10,8 +11,11 @@ UFDS::UFDS(unsigned int N) {
 }
 
 unsigned long UFDS::findSet(unsigned int i) {
-    if (path[i] != i) path[i] = findSet(path[i]);
-    return path[i];
+    while (path[i] != i) {
+        path[i] = path[path[i]]; // path halving: point i to its grandparent and move up
+        i = path[i];
+    }
+    return i;
 }
 
 bool UFDS::isSameSet(unsigned int i, unsigned int j) {
@@ -27,4 +31,38 @@ void UFDS::linkSets(unsigned int i, unsigned int j) {
             if (rank[x] == rank[y]) rank[y]++; // ... due to both nodes having the same rank (in order to break the tie)
         }
     }
+}
+
+ConcurrentUFDS::ConcurrentUFDS(unsigned int N): path(N) {
+    for (unsigned int i = 0; i < N; i++) path[i].store(i, std::memory_order_relaxed);
+}
+
+unsigned int ConcurrentUFDS::findSet(unsigned int i) {
+    while (true) {
+        unsigned int parent = path[i].load(std::memory_order_acquire);
+        if (parent == i) return i;
+        unsigned int grandparent = path[parent].load(std::memory_order_acquire);
+        if (parent != grandparent) path[i].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+        i = grandparent;
+    }
+}
+
+bool ConcurrentUFDS::isSameSet(unsigned int i, unsigned int j) {
+    while (true) {
+        i = findSet(i);
+        j = findSet(j);
+        if (i == j) return true;
+        if (path[i].load(std::memory_order_acquire) == i) return false; // i was still a root after finding j
+    }
+}
+
+bool ConcurrentUFDS::linkSets(unsigned int i, unsigned int j) {
+    while (true) {
+        i = findSet(i);
+        j = findSet(j);
+        if (i == j) return false;
+        if (i < j) std::swap(i, j);
+        unsigned int expected = i;
+        if (path[i].compare_exchange_strong(expected, j, std::memory_order_acq_rel)) return true;
+    }
 }
\ No newline at end of file
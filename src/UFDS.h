@@ -3,6 +3,7 @@
 #ifndef DA_TP_CLASSES_UFDS
 #define DA_TP_CLASSES_UFDS
 
+#include <atomic>
 #include <vector>
 
 class UFDS {
@@ -14,10 +15,10 @@ public:
      */
     UFDS(unsigned int N);
     /**
-     * Finds the set which the node i is contained in.
+     * Finds the set which the node i is contained in. Iterative, halving the path from i to the root on the way up.
      * @param i Represents a node
      * @return The path of node i
-     * @note Time-complexity -> O(n), where n is the number of elements in the set.
+     * @note Time-complexity -> O(n), where n is the number of elements in the set. O(log(n)) amortized, as the sets are linked by rank.
      */
     unsigned long findSet(unsigned int i);
     /**
@@ -40,5 +41,40 @@ private:
     std::vector<unsigned int> rank; // Upper bound for the height of a tree whose root is node i.
 };
 
+class ConcurrentUFDS {
+public:
+    /**
+     * Constructor for the ConcurrentUFDS class, a lock-free version of UFDS that can be used by several threads at once.
+     * @param N Represents the number of elements, each one starting in its own set
+     * @note Time-complexity -> O(N) with N being the variable N passed as parameter
+     */
+    explicit ConcurrentUFDS(unsigned int N);
+    /**
+     * Finds the set which the node i is contained in, halving the path to the root with compare-and-swap.
+     * @param i Represents a node
+     * @return The root of the set of node i
+     * @note Time-complexity -> O(log(n)) amortized, where n is the number of elements.
+     */
+    unsigned int findSet(unsigned int i);
+    /**
+     * Checks if i and j, passed as parameters, are in the same set.
+     * @param i Represents one of the nodes
+     * @param j Represents one of the nodes
+     * @return True if the nodes are in the same set, false otherwise.
+     * @note Time-complexity -> O(log(n)) amortized, where n is the number of elements.
+     */
+    bool isSameSet(unsigned int i, unsigned int j);
+    /**
+     * Links the sets of i and j if they are not the same set. The root with the higher index is linked below the other
+     * one, so concurrent links can never form a cycle.
+     * @param i Represents one of the nodes
+     * @param j Represents one of the nodes
+     * @return True if the sets were linked, false if i and j were already in the same set.
+     * @note Time-complexity -> O(log(n)) amortized, where n is the number of elements.
+     */
+    bool linkSets(unsigned int i, unsigned int j);
+private:
+    std::vector<std::atomic<unsigned int>> path; // Ancestor of node i (which can be itself).
+};
 
 #endif //DA_TP_CLASSES_UFDS
@@ -0,0 +1,464 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "Graph.h"
+#include "parse.h"
+#include "ArtifactCache.h"
+#include "CandidateSet.h"
+#include "IteratedLocalSearch.h"
+#include "MultiVehicle.h"
+#include "OneTreeBound.h"
+
+using namespace std;
+
+/**
+ * One line of the jobs file: a dataset, the algorithm to run on it and its parameters.
+ */
+struct Job {
+    unsigned int index = 0;
+    string type;            // toy, extra or real, as in loadDataset
+    string path;
+    string algorithm;       // bt, tah, kmeans, ils or fleet
+    unsigned int k = 0;     // kmeans: number of clusters, 0 for sqrt(n)
+    unsigned int seed = 0;  // kmeans and ils: seed of the centroids or of the kicks, 0 for the current time
+    double time = -1;       // ils: time budget in seconds (10 if not given); fleet: local search time per route (none if not given)
+    unsigned int vehicles = 1;      // fleet: number of vehicles
+    Balance balance = Balance::COUNT;   // fleet: what the groups of stops are balanced by
+    unsigned int workers = 0;   // ils: number of workers, 0 for one per hardware thread
+    bool bound = false;     // also compute the Held-Karp lower bound and the gap of the tour to it
+    Storage storage = Storage::DOUBLE;  // how the weights and coordinates are stored
+    bool useCandidates = false;     // load (or build and save) a candidate set next to the dataset, used by ils
+    CandidateKind candidates = CandidateKind::NEAREST;
+    long long lazyEdges = -1;       // slots of the cache of missing edges, -1 for the default of loadDataset
+};
+
+struct JobResult {
+    string status = "ok";
+    int nodes = 0;
+    double tourLength = 0;
+    vector<int> tour;       // ids, as the nodes are freed with the graph of the job
+    vector<vector<int>> routes;     // fleet: ids of the route of each vehicle, with its cost
+    vector<double> routeCosts;
+    double loadMs = 0, solveMs = 0;
+    vector<pair<double, double>> history;   // ils: (ms, tour length) at each improvement
+    double lowerBound = -1, gap = 0, boundMs = 0;   // bound: lowerBound is -1 if it was not computed
+    bool boundComplete = true;      // bound: false if it was only taken over the candidate edges, so it bounds no tour
+    double candidatesMs = -1;       // candidates: -1 if no candidate set was asked for
+    bool candidatesCached = false;
+    IngestStats ingest;     // rows read and dropped, if the dataset files were parsed
+    bool cacheUsed = false;
+    vector<string> cacheHits;       // stages read from the artifact cache: graph, candidates, tour and bound
+};
+
+/**
+ * Parses the jobs file. Each line has the form "type,path,algorithm[,key=value...]"; empty lines and lines starting with
+ * '#' are skipped.
+ * @param in Represents the stream with the jobs
+ * @param jobs Represents the vector to which the jobs are appended
+ * @return True if every line could be parsed, false otherwise (the error is printed to cerr)
+ * @note Time-complexity -> O(n) with n being the size of the input
+ */
+bool parseJobs(istream& in, vector<Job>& jobs){
+    string line;
+    unsigned int lineNumber = 0;
+    while(getline(in, line)){
+        lineNumber++;
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(line.empty() || line[0] == '#') continue;
+        vector<string> info = read(line);
+        if(info.size() < 3){
+            cerr << "Line " << lineNumber << ": expected type,path,algorithm\n";
+            return false;
+        }
+        Job job;
+        job.index = jobs.size();
+        job.type = info[0];
+        job.path = info[1];
+        job.algorithm = info[2];
+        for(int i = 3; i < info.size(); i++){
+            size_t eq = info[i].find('=');
+            string key = info[i].substr(0, eq), value = eq == string::npos ? "" : info[i].substr(eq + 1);
+            try{
+                if(key == "k") job.k = stoul(value);
+                else if(key == "seed") job.seed = stoul(value);
+                else if(key == "time") job.time = stod(value);
+                else if(key == "workers") job.workers = stoul(value);
+                else if(key == "bound") job.bound = value != "0";
+                else if(key == "vehicles") job.vehicles = stoul(value);
+                else if(key == "balance"){
+                    if(!MultiVehicle::parse(value, job.balance)){
+                        cerr << "Line " << lineNumber << ": unknown balance " << value << "\n";
+                        return false;
+                    }
+                }
+                else if(key == "lazy") job.lazyEdges = stoll(value);
+                else if(key == "candidates"){
+                    job.useCandidates = true;
+                    if(!CandidateSet::parse(value, job.candidates)){
+                        cerr << "Line " << lineNumber << ": unknown candidates " << value << "\n";
+                        return false;
+                    }
+                }
+                else if(key == "storage"){
+                    if(!Precision::parse(value, job.storage)){
+                        cerr << "Line " << lineNumber << ": unknown storage " << value << "\n";
+                        return false;
+                    }
+                }
+                else {
+                    cerr << "Line " << lineNumber << ": unknown parameter " << key << "\n";
+                    return false;
+                }
+            } catch(const logic_error&){
+                cerr << "Line " << lineNumber << ": invalid value " << value << " for " << key << "\n";
+                return false;
+            }
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+/**
+ * Checks if the algorithm of the job always gives the same tour on the same dataset, so that the tour can be cached:
+ * kmeans only with a fixed seed, fleet only without the local search, and never ils, which is bound by time.
+ * @note Time-complexity -> O(1)
+ */
+bool isDeterministic(const Job& job){
+    if(job.algorithm == "bt" || job.algorithm == "tah") return true;
+    if(job.algorithm == "kmeans") return job.seed != 0;
+    if(job.algorithm == "fleet") return job.time <= 0;
+    return false;
+}
+
+/**
+ * Returns the parameters the tour of the job depends on, for the key of its cache entry.
+ * @note Time-complexity -> O(1)
+ */
+string tourParams(const Job& job){
+    ostringstream params;
+    params << "algorithm=" << job.algorithm << ",type=" << job.type << ",storage=" << (int) job.storage << ",k=" << job.k
+           << ",seed=" << job.seed << ",vehicles=" << job.vehicles << ",balance=" << (int) job.balance;
+    return params.str();
+}
+
+/**
+ * Returns the parameters the bound of a tour depends on: the bound starts from the length of the tour, so it is part of the key.
+ * @note Time-complexity -> O(1)
+ */
+string boundParams(const Job& job, double tourLength){
+    ostringstream params;
+    params << "type=" << job.type << ",storage=" << (int) job.storage << ",tour=" << hexfloat << tourLength;
+    return params.str();
+}
+
+/**
+ * Writes the number of nodes, the tour and the routes of a result, for the cache.
+ * @note Time-complexity -> O(n) with n being the size of the tour and routes
+ */
+string serializeTour(const JobResult& result){
+    string payload;
+    BinaryWriter writer(payload);
+    writer.put((uint32_t) result.nodes);
+    writer.put(result.tourLength);
+    writer.put((uint32_t) result.tour.size());
+    for(int id : result.tour) writer.put((int32_t) id);
+    writer.put((uint32_t) result.routes.size());
+    for(int r = 0; r < result.routes.size(); r++){
+        writer.put(result.routeCosts[r]);
+        writer.put((uint32_t) result.routes[r].size());
+        for(int id : result.routes[r]) writer.put((int32_t) id);
+    }
+    return payload;
+}
+
+/**
+ * Reads what serializeTour wrote into the result.
+ * @return True if the payload was valid, false otherwise
+ * @note Time-complexity -> O(n) with n being the size of the payload
+ */
+bool deserializeTour(const string& payload, JobResult& result){
+    BinaryReader reader(payload);
+    uint32_t nodes, size, routes;
+    if(!reader.get(nodes) || !reader.get(result.tourLength) || !reader.get(size) || size > payload.size()) return false;
+    result.nodes = nodes;
+    result.tour.resize(size);
+    for(int& id : result.tour) if(!reader.get(id)) return false;
+    if(!reader.get(routes) || routes > payload.size()) return false;
+    result.routes.resize(routes);
+    result.routeCosts.resize(routes);
+    for(int r = 0; r < routes; r++){
+        if(!reader.get(result.routeCosts[r]) || !reader.get(size) || size > payload.size()) return false;
+        result.routes[r].resize(size);
+        for(int& id : result.routes[r]) if(!reader.get(id)) return false;
+    }
+    return reader.done();
+}
+
+/**
+ * Loads the dataset of the job into a graph of its own and runs the algorithm of the job on it. With a cache, every stage
+ * whose result is in it is skipped: the graph is read back instead of parsed, the candidates are read back instead of
+ * built, and the tour of a deterministic algorithm (and its bound) is read back without even loading the graph.
+ * @param job Represents the job to run
+ * @param cache Represents the artifact cache, nullptr for none
+ * @return The result of the job, with the time spent loading and solving
+ * @note Time-complexity -> The one of the reader and of the algorithm used, O(n) with n being the size of the dataset
+ * files if every stage is cached
+ */
+JobResult runJob(const Job& job, const ArtifactCache* cache){
+    JobResult result;
+    Graph graph;
+
+    auto start = chrono::steady_clock::now();
+    uint64_t datasetHash = 0;
+    result.cacheUsed = cache != nullptr && ArtifactCache::hashDataset(job.type, job.path, datasetHash);
+    string payload;
+    bool tourCached = result.cacheUsed && isDeterministic(job) && cache->load(datasetHash, "tour", tourParams(job), payload)
+                      && deserializeTour(payload, result);
+    bool boundCached = false;
+    if(tourCached){
+        result.cacheHits.emplace_back("tour");
+        if(job.bound && result.routes.empty() && cache->load(datasetHash, "bound", boundParams(job, result.tourLength), payload)){
+            BinaryReader reader(payload);
+            boundCached = reader.get(result.lowerBound) && reader.get(result.gap) && reader.get(result.boundComplete) && reader.done();
+            if(boundCached) result.cacheHits.emplace_back("bound");
+            else result.lowerBound = -1;
+        }
+        if(!job.bound || !result.routes.empty() || boundCached){
+            result.loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            return result;
+        }
+    }
+
+    bool loaded, graphCached = false;
+    if(result.cacheUsed) loaded = loadDataset(&graph, job.type, job.path, job.storage, *cache, datasetHash, graphCached, &result.ingest);
+    else loaded = loadDataset(&graph, job.type, job.path, job.storage, &result.ingest);
+    if(graphCached) result.cacheHits.emplace_back("graph");
+    auto loadEnd = chrono::steady_clock::now();
+    result.loadMs = chrono::duration<double, milli>(loadEnd - start).count();
+    if(!tourCached) result.nodes = graph.getNumNode();
+    if(!loaded){
+        result.status = "load_error";
+        return result;
+    }
+    if(graph.getNumNode() == 0){
+        result.status = "empty_dataset";
+        return result;
+    }
+    if(job.lazyEdges >= 0) graph.setLazyEdges(job.lazyEdges);
+
+    CandidateSet candidates(graph);
+    if(job.useCandidates && !tourCached){
+        // ranked by getDistance, so a toy graph needs its missing distances first
+        if(job.type == "toy") MatrixDistance::prepare(graph);
+        if(!result.cacheUsed) ArtifactCache::hashDataset(job.type, job.path, datasetHash);
+        string path = result.cacheUsed ? cache->pathFor(datasetHash, "candidates", "kind=" + to_string((int) job.candidates) + ",storage=" + to_string((int) job.storage))
+                                       : CandidateSet::pathFor(job.path, job.candidates, job.storage);
+        if(result.cacheUsed) filesystem::create_directories(cache->getDirectory());
+        bool built = candidates.loadOrBuild(path, datasetHash, job.candidates);
+        result.candidatesCached = candidates.wasLoaded();
+        if(result.candidatesCached && result.cacheUsed) result.cacheHits.emplace_back("candidates");
+        result.candidatesMs = chrono::duration<double, milli>(chrono::steady_clock::now() - loadEnd).count();
+        if(!built){
+            result.status = "candidates_error";
+            return result;
+        }
+    }
+    auto candidatesEnd = chrono::steady_clock::now();
+
+    vector<Node*> tour;
+    if(!tourCached){
+        if(job.algorithm == "bt"){
+            result.tourLength = graph.tspBT(tour);
+        } else if(job.algorithm == "tah"){
+            result.tourLength = graph.TriangularApproximationHeuristic(graph.getNodeSet(), tour, job.type);
+        } else if(job.algorithm == "kmeans"){
+            vector<Node*> emptyCluster;
+            int k = job.k != 0 ? job.k : sqrt(graph.getNumNode());
+            tour = graph.kMeansDivideAndConquer(k, emptyCluster, result.tourLength, true, job.seed);
+        } else if(job.algorithm == "ils"){
+            vector<Node*> start;
+            graph.TriangularApproximationHeuristic(graph.getNodeSet(), start, job.type);
+            IteratedLocalSearch search(graph, start, job.useCandidates ? &candidates : nullptr);
+            unsigned int workers = job.workers != 0 ? job.workers : thread::hardware_concurrency();
+            result.tourLength = search.run(workers, job.time >= 0 ? job.time : 10, job.seed != 0 ? job.seed : time(nullptr));
+            tour = search.getTour();
+            result.history = search.getHistory();
+        } else if(job.algorithm == "fleet"){
+            MultiVehicle fleet(graph, job.type, job.vehicles, job.balance);
+            result.tourLength = fleet.run(max(0.0, job.time), job.seed != 0 ? job.seed : time(nullptr));
+            for(const vector<Node*>& route : fleet.getRoutes()){
+                result.routes.emplace_back();
+                for(Node* node : route) result.routes.back().push_back(node->getId());
+            }
+            result.routeCosts = fleet.getCosts();
+        } else {
+            result.status = "unknown_algorithm";
+        }
+    }
+    if(find(tour.begin(), tour.end(), nullptr) != tour.end()){
+        // tspBT leaves the path empty when the graph has no tour it can close
+        result.status = "no_tour";
+        result.tourLength = 0;
+        tour.clear();
+    }
+    for(Node* node : tour) result.tour.push_back(node->getId());
+    auto solveEnd = chrono::steady_clock::now();
+    result.solveMs = chrono::duration<double, milli>(solveEnd - candidatesEnd).count();
+    if(result.cacheUsed && !tourCached && result.status == "ok" && isDeterministic(job)){
+        cache->store(datasetHash, "tour", tourParams(job), serializeTour(result));
+    }
+
+    if(job.bound && result.status == "ok" && result.routes.empty()){
+        OneTreeBound bound(graph);
+        if(bound.run(result.tourLength)){
+            result.lowerBound = bound.getBound();
+            result.gap = bound.getGap(result.tourLength);
+            result.boundComplete = bound.isComplete();
+        }
+        result.boundMs = chrono::duration<double, milli>(chrono::steady_clock::now() - solveEnd).count();
+        if(result.cacheUsed){
+            payload.clear();
+            BinaryWriter writer(payload);
+            writer.put(result.lowerBound);
+            writer.put(result.gap);
+            writer.put(result.boundComplete);
+            cache->store(datasetHash, "bound", boundParams(job, result.tourLength), payload);
+        }
+    }
+    return result;
+}
+
+/**
+ * Writes the result of a job as one JSON object per line, or as one CSV row (tour ids separated by spaces, and the routes
+ * of a fleet separated by " | ").
+ * @note Time-complexity -> O(n) with n being the size of the tour
+ */
+void writeResult(ostream& out, const Job& job, const JobResult& result, bool csv){
+    ostringstream line;
+    line.precision(15);
+    if(csv){
+        line << job.index << ',' << job.type << ",\"" << job.path << "\"," << job.algorithm << ',' << result.status << ','
+             << result.nodes << ',' << result.tourLength << ',' << result.loadMs << ',' << result.solveMs << ',';
+        for(int i = 0; i < result.tour.size(); i++) line << (i ? " " : "") << result.tour[i];
+        for(int r = 0; r < result.routes.size(); r++){
+            line << (r ? " | " : "");
+            for(int i = 0; i < result.routes[r].size(); i++) line << (i ? " " : "") << result.routes[r][i];
+        }
+    } else {
+        line << "{\"job\":" << job.index << ",\"type\":\"" << job.type << "\",\"dataset\":\"" << escapeJson(job.path)
+             << "\",\"algorithm\":\"" << escapeJson(job.algorithm) << "\",\"status\":\"" << result.status
+             << "\",\"nodes\":" << result.nodes << ",\"tour_length\":" << result.tourLength
+             << ",\"load_ms\":" << result.loadMs << ",\"solve_ms\":" << result.solveMs << ",\"tour\":[";
+        for(int i = 0; i < result.tour.size(); i++) line << (i ? "," : "") << result.tour[i];
+        line << "]";
+        if(!result.history.empty()){
+            line << ",\"history\":[";
+            for(int i = 0; i < result.history.size(); i++) line << (i ? "," : "") << "[" << result.history[i].first << "," << result.history[i].second << "]";
+            line << "]";
+        }
+        if(!result.routes.empty()){
+            line << ",\"routes\":[";
+            for(int r = 0; r < result.routes.size(); r++){
+                line << (r ? "," : "") << "{\"cost\":" << result.routeCosts[r] << ",\"tour\":[";
+                for(int i = 0; i < result.routes[r].size(); i++) line << (i ? "," : "") << result.routes[r][i];
+                line << "]}";
+            }
+            line << "]";
+        }
+        if(result.candidatesMs >= 0){
+            line << ",\"candidates_ms\":" << result.candidatesMs << ",\"candidates_cached\":" << (result.candidatesCached ? "true" : "false");
+        }
+        const IngestStats& ingest = result.ingest;
+        if(ingest.rows + ingest.malformed > 0){
+            line << ",\"ingest\":{\"rows\":" << ingest.rows << ",\"edges\":" << ingest.edges << ",\"dropped\":" << ingest.dropped()
+                 << ",\"duplicates\":" << ingest.duplicates << ",\"self_loops\":" << ingest.selfLoops
+                 << ",\"unknown_nodes\":" << ingest.unknownNodes << ",\"malformed\":" << ingest.malformed << "}";
+        }
+        if(result.cacheUsed){
+            line << ",\"cache_hits\":[";
+            for(int i = 0; i < result.cacheHits.size(); i++) line << (i ? "," : "") << "\"" << result.cacheHits[i] << "\"";
+            line << "]";
+        }
+        if(result.lowerBound >= 0){
+            // over the candidate edges only, the tours of the solvers can be shorter than the bound, so it is kept apart
+            if(result.boundComplete) line << ",\"lower_bound\":" << result.lowerBound << ",\"gap\":" << result.gap;
+            else line << ",\"candidate_bound\":" << result.lowerBound << ",\"candidate_gap\":" << result.gap;
+            line << ",\"bound_ms\":" << result.boundMs;
+        }
+        line << "}";
+    }
+    out << line.str() << endl;
+}
+
+int main(int argc, char** argv){
+    string jobsFile, outputFile, cacheDirectory;
+    unsigned int nThreads = thread::hardware_concurrency();
+    bool csv = false;
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "-j" && i + 1 < argc) nThreads = stoul(argv[++i]);
+        else if(arg == "--format" && i + 1 < argc) csv = string(argv[++i]) == "csv";
+        else if(arg == "-o" && i + 1 < argc) outputFile = argv[++i];
+        else if(arg == "--cache" && i + 1 < argc) cacheDirectory = argv[++i];
+        else if(jobsFile.empty()) jobsFile = arg;
+        else jobsFile.clear(), i = argc;
+    }
+    if(jobsFile.empty()){
+        cerr << "Usage: " << argv[0] << " <jobs file | -> [-j threads] [--format json|csv] [-o output file]\n"
+                "[--cache directory]\n"
+                "Each line of the jobs file is type,path,algorithm[,k=..][,seed=..][,time=..][,workers=..][,bound=1]\n"
+                "[,storage=double|float32|fixed][,candidates=nearest|quadrant|alpha][,lazy=..][,vehicles=..]\n"
+                "[,balance=count|distance] with type toy|extra|real (path is the directory with nodes.csv and edges.csv\n"
+                "for real) and algorithm bt|tah|kmeans|ils|fleet. With --cache, the parsed graphs, candidate sets, tours\n"
+                "and bounds are kept in the directory and reused by the next runs on the same dataset contents.\n";
+        return 2;
+    }
+
+    vector<Job> jobs;
+    bool parsed;
+    if(jobsFile == "-") parsed = parseJobs(cin, jobs);
+    else {
+        ifstream in(jobsFile);
+        if(!in.is_open()){
+            cerr << "Error when opening file " << jobsFile << endl;
+            return 2;
+        }
+        parsed = parseJobs(in, jobs);
+    }
+    if(!parsed) return 2;
+
+    ofstream file;
+    if(!outputFile.empty()) file.open(outputFile);
+    ostream& out = outputFile.empty() ? cout : file;
+    if(csv) out << "job,type,dataset,algorithm,status,nodes,tour_length,load_ms,solve_ms,tour" << endl;
+
+    // each worker takes the next job, so long and short jobs balance out; results are written as they finish
+    unique_ptr<ArtifactCache> cache;
+    if(!cacheDirectory.empty()) cache = make_unique<ArtifactCache>(cacheDirectory);
+    atomic<unsigned int> nextJob{0};
+    atomic<bool> allOk{true};
+    mutex outMutex;
+    auto worker = [&](){
+        for(unsigned int j = nextJob++; j < jobs.size(); j = nextJob++){
+            JobResult result = runJob(jobs[j], cache.get());
+            if(result.status != "ok") allOk = false;
+            lock_guard<mutex> lock(outMutex);
+            writeResult(out, jobs[j], result, csv);
+        }
+    };
+    vector<thread> workers;
+    for(unsigned int t = 1; t < max(1u, min<unsigned int>(nThreads, jobs.size())); t++) workers.emplace_back(worker);
+    worker();
+    for(thread& t : workers) t.join();
+
+    return allOk ? 0 : 1;
+}
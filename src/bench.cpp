@@ -0,0 +1,233 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include "Graph.h"
+#include "parse.h"
+#include "TourStitcher.h"
+#include "Tour.h"
+
+using namespace std;
+
+struct BenchOptions {
+    vector<int> sizes = {10, 100, 1000, 10000};
+    string filter;
+    double minTimeMs = 200;
+    bool csv = false;
+};
+
+static BenchOptions options;
+
+/**
+ * Runs body repeatedly until at least options.minTimeMs have been spent in it, running setup (untimed) before each call,
+ * and prints one line with the number of iterations and the mean and minimum time per call. A benchmark left out by
+ * --filter runs once without being timed or printed.
+ * @param name Represents the name of the benchmark
+ * @param size Represents the size of the input, for the output line
+ * @param setup Represents the work that must be redone before each call of body, if any
+ * @param body Represents the code being measured
+ * @note Time-complexity -> O(I * (S + B)) with I being the number of iterations and S and B the costs of setup and body
+ */
+void benchmark(const string& name, int size, const function<void()>& setup, const function<void()>& body){
+    if(!options.filter.empty() && name.find(options.filter) == string::npos){
+        // still run once, untimed, since later benchmarks build on its results
+        if(setup) setup();
+        body();
+        return;
+    }
+    double totalNs = 0, minNs = numeric_limits<double>::max();
+    unsigned long iterations = 0;
+    while(totalNs < options.minTimeMs * 1e6 || iterations == 0){
+        if(setup) setup();
+        auto start = chrono::steady_clock::now();
+        body();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        totalNs += ns;
+        minNs = min(minNs, ns);
+        iterations++;
+    }
+    if(options.csv) printf("%s,%d,%lu,%.1f,%.1f\n", name.c_str(), size, iterations, totalNs / iterations, minNs);
+    else printf("{\"benchmark\":\"%s\",\"size\":%d,\"iterations\":%lu,\"mean_ns\":%.1f,\"min_ns\":%.1f}\n",
+                name.c_str(), size, iterations, totalNs / iterations, minNs);
+    fflush(stdout);
+}
+
+/**
+ * Synthetic real-world-like dataset: n nodes spread over a city-sized box and a list of edges weighted by their haversine
+ * distance. Complete up to 1000 nodes, otherwise a ring plus 8 random edges per node.
+ */
+struct Dataset {
+    vector<array<double, 2>> coords;                 // (longitude, latitude)
+    vector<tuple<int, int, double>> edges;
+};
+
+Dataset makeDataset(int n, unsigned int seed){
+    mt19937 rng(seed);
+    uniform_real_distribution<double> lon(-8.7, -8.5), lat(41.1, 41.2);
+    Dataset dataset;
+    for(int i = 0; i < n; i++) dataset.coords.push_back({lon(rng), lat(rng)});
+    auto addEdge = [&](int u, int v){
+        dataset.edges.emplace_back(u, v, haversineDistance(dataset.coords[u][0], dataset.coords[u][1], dataset.coords[v][0], dataset.coords[v][1]));
+    };
+    if(n <= 1000){
+        for(int u = 0; u < n; u++) for(int v = u + 1; v < n; v++) addEdge(u, v);
+    } else {
+        for(int u = 0; u < n; u++){
+            addEdge(u, (u + 1) % n);
+            for(int e = 0; e < 8; e++){
+                int v = rng() % n;
+                if(v != u) addEdge(u, v);
+            }
+        }
+    }
+    return dataset;
+}
+
+void buildGraph(Graph& graph, const Dataset& dataset){
+    for(int i = 0; i < dataset.coords.size(); i++) graph.addNode(i, dataset.coords[i][0], dataset.coords[i][1]);
+    for(auto& [u, v, w] : dataset.edges) graph.addBidirectionalEdge(u, v, w);
+    graph.sortEdges();
+}
+
+void benchmarkParsing(int n, const Dataset& dataset){
+    filesystem::path dir = filesystem::temp_directory_path() / ("tsp_bench_" + to_string(n));
+    filesystem::create_directories(dir);
+    {
+        ofstream nodes(dir / "nodes.csv"), edges(dir / "edges.csv");
+        nodes.precision(10);
+        edges.precision(10);
+        nodes << "id,longitude,latitude\n";
+        for(int i = 0; i < n; i++) nodes << i << ',' << dataset.coords[i][0] << ',' << dataset.coords[i][1] << '\n';
+        edges << "origem,destino,haversine_distance\n";
+        for(auto& [u, v, w] : dataset.edges) edges << u << ',' << v << ',' << w << '\n';
+    }
+    Graph graph;
+    benchmark("parse/readRealWorld", n, [&](){ graph.cleanGraph(); }, [&](){
+        readRealWorldNodes(&graph, (dir / "nodes.csv").string());
+        readRealWorldEdges(&graph, (dir / "edges.csv").string());
+    });
+    graph.cleanGraph();
+    filesystem::remove_all(dir);
+}
+
+void benchmarkSize(int n){
+    Dataset dataset = makeDataset(n, n);
+    benchmarkParsing(n, dataset);
+
+    Graph graph;
+    benchmark("graph/build(addNode+addBidirectionalEdge)", n, [&](){ graph.cleanGraph(); }, [&](){
+        buildGraph(graph, dataset);
+    });
+
+    mt19937 rng(1);
+    vector<int> queries(1000);
+    for(int& q : queries) q = rng() % n;
+    benchmark("graph/findNode", n, nullptr, [&](){
+        for(int q : queries) if(graph.findNode(q) == nullptr) abort();
+    });
+
+    benchmark("calculations/haversineDistance", n, nullptr, [&](){
+        volatile double sum = 0;
+        for(int i = 0; i + 1 < n; i++) sum = sum + haversineDistance(dataset.coords[i][0], dataset.coords[i][1], dataset.coords[i + 1][0], dataset.coords[i + 1][1]);
+    });
+
+    benchmark("graph/kruskal", n, nullptr, [&](){ graph.kruskal(); });
+
+    vector<Node*> tour;
+    double weight = 0;
+    benchmark("graph/preOrder", n, [&](){
+        tour.clear();
+        weight = 0;
+    }, [&](){ graph.preOrder<GeographicDistance>(graph.getNodeSet()[0], tour, true, weight); });
+
+    vector<Node*> nodes = graph.getNodeSet(), centroids;
+    for(int c = 0; c < max(1, (int) sqrt(n)); c++){
+        Node* centroid = new Node(c, nodes[c * n / max(1, (int) sqrt(n))]->getLon(), nodes[c * n / max(1, (int) sqrt(n))]->getLat());
+        centroid->setCluster(c);
+        centroids.push_back(centroid);
+    }
+    benchmark("graph/makeClusters", n, nullptr, [&](){ Graph::makeClusters(centroids, nodes); });
+    for(Node* centroid : centroids) delete centroid;
+
+    // two halves of the preOrder tour, as two solved sub-tours to be joined
+    vector<Node*> first(tour.begin(), tour.begin() + tour.size() / 2), second(tour.begin() + tour.size() / 2, tour.end() - 1);
+    if(n <= 1000){
+        benchmark("graph/joinSolvedTSP", n, nullptr, [&](){
+            double joinedWeight;
+            Graph::joinSolvedTSP(first, second, joinedWeight);
+        });
+    }
+    graph.indexEdges();
+    // pairs of nodes mostly without an edge between them, asked for over and over as a local search would
+    vector<pair<Node*, Node*>> pairs(1000);
+    for(auto& [a, b] : pairs){
+        a = nodes[rng() % n];
+        b = nodes[rng() % n];
+    }
+    benchmark("graph/getDistance(missing)", n, nullptr, [&](){
+        volatile double sum = 0;
+        for(auto& [a, b] : pairs) sum = sum + graph.getDistance(a, b);
+    });
+    graph.setLazyEdges(1 << 16);
+    benchmark("graph/getDistance(missing,lazy)", n, nullptr, [&](){
+        volatile double sum = 0;
+        for(auto& [a, b] : pairs) sum = sum + graph.getDistance(a, b);
+    });
+    graph.setLazyEdges(0);
+
+    TourStitcher stitcher(graph);
+    vector<Node*> solved, add;
+    benchmark("stitcher/join", n, [&](){
+        solved = first;
+        add = second;
+    }, [&](){ stitcher.join(solved, 0, add, 0); });
+
+    Tour cycle(graph, nodes);
+    vector<pair<Node*, Node*>> reversals(1000);
+    for(auto& [from, to] : reversals){
+        from = nodes[rng() % n];
+        to = nodes[rng() % n];
+    }
+    benchmark("tour/reverse", n, nullptr, [&](){
+        for(auto& [from, to] : reversals) cycle.reverse(from, to);
+    });
+
+    if(n <= 12){
+        benchmark("graph/tspBT", n, nullptr, [&](){
+            vector<Node*> path;
+            graph.tspBT(path);
+        });
+    }
+    graph.cleanGraph();
+}
+
+int main(int argc, char** argv){
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "--sizes" && i + 1 < argc){
+            options.sizes.clear();
+            stringstream list(argv[++i]);
+            string size;
+            while(getline(list, size, ',')) options.sizes.push_back(stoi(size));
+        }
+        else if(arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if(arg == "--min-time" && i + 1 < argc) options.minTimeMs = stod(argv[++i]);
+        else if(arg == "--format" && i + 1 < argc) options.csv = string(argv[++i]) == "csv";
+        else {
+            cerr << "Usage: " << argv[0] << " [--sizes 10,100,1000,10000] [--filter name] [--min-time ms] [--format json|csv]\n";
+            return 2;
+        }
+    }
+    if(options.csv) printf("benchmark,size,iterations,mean_ns,min_ns\n");
+    for(int n : options.sizes) if(n >= 2) benchmarkSize(n);
+    return 0;
+}
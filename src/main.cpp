@@ -6,13 +6,14 @@
 #include "Graph.h"
 #include "parse.h"
 #include "print.h"
+#include "DatasetCatalog.h"
 #include <string>
+#include <sstream>
 #include <chrono>
 
 using namespace std;
 
-void toyGraph(Graph* graph,const string& file){
-    readToyGraph(graph,file);
+void toyGraph(Graph* graph){
     bool choosingToyEuristic = true;
     int chooseToyEuristic;
     while (choosingToyEuristic){
@@ -50,10 +51,8 @@ void toyGraph(Graph* graph,const string& file){
                 std::vector<Node*> mst;
                 auto start = chrono::steady_clock::now();
 
-                min = graph->TriangularApproximationHeuristic(graph->getNodeSet(),mst,"toy","2");
+                min = graph->TriangularApproximationHeuristic<MatrixDistance>(graph->getNodeSet(),mst);
                 printPath(mst,min);
-                graph->cleanGraph();
-                readToyGraph(graph,file);
 
                 auto end = chrono::steady_clock::now();
                 cout << "Finished in: " <<  chrono::duration_cast<chrono::milliseconds > (end - start).count() << " ms\n";
@@ -67,8 +66,7 @@ void toyGraph(Graph* graph,const string& file){
     }
 }
 
-void efcGraph(Graph* graph,const string& file){
-    readExtraFullyConnectedGraph(graph,file);
+void efcGraph(Graph* graph){
     bool choosingAlg = true;
     int chooseAlg;
     while (choosingAlg){
@@ -101,7 +99,7 @@ void efcGraph(Graph* graph,const string& file){
             }
             case 2: {
                 std::vector<Node*> mst;
-                min = graph->TriangularApproximationHeuristic(graph->getNodeSet(),mst,"extra","2");
+                min = graph->TriangularApproximationHeuristic<ExplicitDistance>(graph->getNodeSet(),mst);
                 printPath(mst,min);
                 break;
             }
@@ -148,7 +146,7 @@ void realGraph1(Graph* graph){
             }
             case 2: {
                 std::vector<Node*> mst;
-                min = graph->TriangularApproximationHeuristic(graph->getNodeSet(),mst,"real","2");
+                min = graph->TriangularApproximationHeuristic<GeographicDistance>(graph->getNodeSet(),mst);
                 printPath(mst,min);
                 break;
             }
@@ -200,7 +198,7 @@ void realGraph23(Graph* graph){
             }
             case 2: {
                 std::vector<Node*> mst;
-                min = graph->TriangularApproximationHeuristic(graph->getNodeSet(),mst,"real","2");
+                min = graph->TriangularApproximationHeuristic<GeographicDistance>(graph->getNodeSet(),mst);
                 printPath(mst,min);
                 break;
             }
@@ -213,7 +211,34 @@ void realGraph23(Graph* graph){
 }
 
 
-void chooseGraph(Graph* graph){
+/**
+ * Builds a menu with the datasets given as parameter, numbered from 1, the ones already loaded by the catalog marked as ready.
+ * @note Time-complexity -> O(D) with D being the number of datasets
+ */
+string datasetMenu(DatasetCatalog& catalog, const string& title, const vector<Dataset>& datasets){
+    ostringstream menu;
+    menu << title << "\n";
+    for(int i = 0; i < datasets.size(); i++){
+        menu << i + 1 << ": " << datasets[i].name;
+        if(catalog.isLoaded(catalog.find(datasets[i].type, datasets[i].name))) menu << " (ready)";
+        menu << "\n";
+    }
+    menu << "0: Go Back\n";
+    return menu.str();
+}
+
+/**
+ * Gets the graph of a dataset from the catalog, loading it if it was not preloaded, and reports if it could not be loaded.
+ * @return The graph, or nullptr if it could not be loaded
+ * @note Time-complexity -> O(1) if loaded, the one of loadDataset otherwise
+ */
+shared_ptr<Graph> acquireDataset(DatasetCatalog& catalog, const Dataset& dataset){
+    shared_ptr<Graph> graph = catalog.acquire(catalog.find(dataset.type, dataset.name));
+    if(graph == nullptr) cout << "Error when loading " << dataset.path << endl;
+    return graph;
+}
+
+void chooseGraph(DatasetCatalog& catalog){
     bool canRun = true;
     while(canRun){
         int typeOfFile;
@@ -241,78 +266,59 @@ void chooseGraph(Graph* graph){
                 canRun=false;
                 break;
             }
-            case 1:{  // Toy
-                int chooseToy;
-                bool choosingToy = true;
-                while(choosingToy){
-                    cout << "Choose a toy graph:\n"
-                            "1: Shipping\n"
-                            "2: Stadiums\n"
-                            "3: Tourism\n"
-                            "0: Go Back\n";
-                    while (!(cin >> chooseToy)) {
+            case 1:   // Toy
+            case 3:{  // real world
+                vector<Dataset> datasets = catalog.getDatasets(typeOfFile == 1 ? "toy" : "real");
+                string title = typeOfFile == 1 ? "Choose a toy graph:" : "Choose a real graph:";
+                int chooseDataset;
+                bool choosingDataset = true;
+                while(choosingDataset){
+                    cout << datasetMenu(catalog, title, datasets);
+                    while (!(cin >> chooseDataset)) {
                         cout << "Invalid input!\n";
                         cin.clear();
                         cin.ignore(INT_MAX, '\n');
-                        cout << "Choose a toy graph:\n"
-                                "1: Shipping\n"
-                                "2: Stadiums\n"
-                                "3: Tourism\n"
-                                "0: Go Back\n";
+                        cout << datasetMenu(catalog, title, datasets);
                     }
                     cin.clear();
                     cin.ignore(INT_MAX, '\n');
-                    string file;
-                    switch (chooseToy) {
-                        case 0:{
-                            choosingToy=false;
-                            break;
-                        }
-                        case 1:{ //shipping
-                            file = "../Project2Graphs/Toy-Graphs/shipping.csv";
-                            toyGraph(graph,file);
-                            graph->cleanGraph();
-                            break;
-                        }
-                        case 2:{ //stadiums
-                            file = "../Project2Graphs/Toy-Graphs/stadiums.csv";
-                            toyGraph(graph,file);
-                            graph->cleanGraph();
-                            break;
-                        }
-                        case 3:{ // tourism
-                            file = "../Project2Graphs/Toy-Graphs/tourism.csv";
-                            toyGraph(graph,file);
-                            graph->cleanGraph();
-                            break;
-                        }
-                        default:{
-                            cout << "Invalid input!\n";
-                            break;
-                        }
+                    if(chooseDataset == 0){
+                        choosingDataset = false;
+                    } else if(chooseDataset > 0 && chooseDataset <= datasets.size()){
+                        const Dataset& dataset = datasets[chooseDataset - 1];
+                        shared_ptr<Graph> graph = acquireDataset(catalog, dataset);
+                        if(graph == nullptr) continue;
+                        if(typeOfFile == 1) toyGraph(graph.get());
+                        else if(dataset.name == "graph1") realGraph1(graph.get());
+                        else realGraph23(graph.get());
+                    } else {
+                        cout << "Invalid input!\n";
                     }
                 }
                 break;
-            } // end of Toy
+            } // end of Toy and real world
             case 2:{ // Extra Fully Connected
+                string numbers;
+                for(const Dataset& dataset : catalog.getDatasets("extra")) numbers += (numbers.empty() ? "" : ",") + dataset.name;
+                string prompt = "Please enter one of these numbers: [" + numbers + "] to choose the EFC graph or 0 to go back\n";
                 int number;
                 bool isChoosingExtra = true;
                 while(isChoosingExtra){
-                    cout << "Please enter one of these numbers: [25,50,75,100,200,300,400,500,600,700,800,900] to choose the EFC graph or 0 to go back\n";
+                    cout << prompt;
                     while (!(cin >> number)) {
                         cout << "Invalid input!\n";
                         cin.clear();
                         cin.ignore(INT_MAX, '\n');
-                        cout << "Please enter one of these numbers: [25,50,75,100,200,300,400,500,600,700,800,900] to choose the EFC graph or 0 to go back\n";
+                        cout << prompt;
                     }
                     cin.clear();
                     cin.ignore(INT_MAX, '\n');
+                    int position = catalog.find("extra", to_string(number));
                     if(number==0){
                         isChoosingExtra=false;
-                    } else if(number == 25 || number == 50 || number == 75 || number==100 || number==200|| number==300|| number==400|| number==500|| number==600|| number==700|| number==800|| number==900){
-                        string extra_fc = "../Project2Graphs/Extra_Fully_Connected_Graphs/edges_" + to_string(number) + ".csv";
-                        efcGraph(graph, extra_fc);
-                        graph->cleanGraph();
+                    } else if(position >= 0){
+                        shared_ptr<Graph> graph = acquireDataset(catalog, catalog.getDatasets()[position]);
+                        if(graph != nullptr) efcGraph(graph.get());
                     }
                     else{
                         cout << "Invalid input!\n";
@@ -320,62 +326,9 @@ void chooseGraph(Graph* graph){
                 }
                 break;
             } // end of EFC
-            case 3:{ // real world
-                int chooseReal;
-                bool choosingReal = true;
-                while(choosingReal){
-                    cout << "Choose a real graph:\n"
-                            "1: graph1\n"
-                            "2: graph2\n"
-                            "3: graph3\n"
-                            "0: Go Back\n";
-                    while (!(cin >> chooseReal)) {
-                        cout << "Invalid input!\n";
-                        cin.clear();
-                        cin.ignore(INT_MAX, '\n');
-                        cout << "Choose a real graph:\n"
-                                "1: graph1\n"
-                                "2: graph2\n"
-                                "3: graph3\n"
-                                "0: Go Back\n";
-                    }
-                    cin.clear();
-                    cin.ignore(INT_MAX, '\n');
-                    switch (chooseReal) {
-                        case 0:{
-                            choosingReal=false;
-                            break;
-                        }
-                        case 1:{
-                            readRealWorldNodes(graph,"../Project2Graphs/Real-World-Graphs/graph1/nodes.csv");
-                            readRealWorldEdges(graph,"../Project2Graphs/Real-World-Graphs/graph1/edges.csv");
-                            realGraph1(graph);
-                            graph->cleanGraph();
-                            break;
-                        }
-                        case 2:{
-                            readRealWorldNodes(graph,"../Project2Graphs/Real-World-Graphs/graph2/nodes.csv");
-                            readRealWorldEdges(graph,"../Project2Graphs/Real-World-Graphs/graph2/edges.csv");
-                            realGraph23(graph);
-                            graph->cleanGraph();
-                            break;
-                        }
-                        case 3:{
-                            readRealWorldNodes(graph,"../Project2Graphs/Real-World-Graphs/graph3/nodes.csv");
-                            readRealWorldEdges(graph,"../Project2Graphs/Real-World-Graphs/graph3/edges.csv");
-                            realGraph23(graph);
-                            graph->cleanGraph();
-                            break;
-                        }
-                        default:{
-                            cout << "Invalid input!\n";
-                            break;
-                        }
-                    }
-                }
-                break;
-            } // end of real world
             case 4:{ // my own
+                Graph own;
+                Graph* graph = &own;
                 string path;
                 int chooseGraphType;
                 bool choosingGraphType= true;
@@ -413,7 +366,8 @@ void chooseGraph(Graph* graph){
                             }
                             cin.clear();
                             cin.ignore(INT_MAX, '\n');
-                            toyGraph(graph,path);
+                            readToyGraph(graph,path);
+                            toyGraph(graph);
                             graph->cleanGraph();
                             break;
                         }
@@ -427,7 +381,8 @@ void chooseGraph(Graph* graph){
                             }
                             cin.clear();
                             cin.ignore(INT_MAX, '\n');
-                            efcGraph(graph, path);
+                            readExtraFullyConnectedGraph(graph,path);
+                            efcGraph(graph);
                             graph->cleanGraph();
                             break;
                         }
@@ -476,10 +431,38 @@ void chooseGraph(Graph* graph){
     }
 }
 
-int main(){
-    Graph graph;
+int main(int argc, char** argv){
+    string dataDirectory = "../Project2Graphs", preloadTypes = "toy,extra,real";
+    size_t budget = DatasetCatalog::DEFAULT_BUDGET;
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "--stats") Stats::enable(true);
+        else if(arg == "--stats-json" && i + 1 < argc){
+            statsJsonFile = argv[++i];
+            Stats::enable(true);
+        }
+        else if(arg == "--stats-trace" && i + 1 < argc){
+            statsTraceFile = argv[++i];
+            Stats::enable(true);
+        }
+        else if(arg == "--data" && i + 1 < argc) dataDirectory = argv[++i];
+        else if(arg == "--preload" && i + 1 < argc) preloadTypes = argv[++i];
+        else if(arg == "--memory" && i + 1 < argc) budget = stoull(argv[++i]) << 20;
+        else{
+            cout << "Usage: " << argv[0] << " [--stats] [--stats-json file] [--stats-trace file] [--data directory]\n"
+                    "[--preload none|toy,extra,real] [--memory MB]\n";
+            return 1;
+        }
+    }
+    DatasetCatalog catalog(dataDirectory, budget);
+    // in the order of the catalog (toy, extra by size, then real), so the small ones are ready first
+    vector<unsigned int> preload;
+    for(unsigned int i = 0; i < catalog.getDatasets().size(); i++){
+        if(("," + preloadTypes + ",").find("," + catalog.getDatasets()[i].type + ",") != string::npos) preload.push_back(i);
+    }
+    catalog.preload(preload);
 
-    chooseGraph(&graph);
+    chooseGraph(catalog);
 
 
     return 0;
@@ -28,6 +28,15 @@ vector<string> read(const string textLine){
     return info;
 }
 
+string escapeJson(const string& text){
+    string escaped;
+    for(char c : text){
+        if(c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
 bool isAlreadyInEdges(int id, std::vector<Edge*> adj){
     if(adj.empty()){
         return false;
@@ -38,88 +47,125 @@ bool isAlreadyInEdges(int id, std::vector<Edge*> adj){
     return false;
 }
 
-void readRealWorldNodes(Graph* graph, string file){
+/**
+ * Queues the edge of a row "origin,destination,distance" into the ingest, or counts the row as malformed.
+ */
+static void ingestEdgeRow(GraphIngest& ingest, const string& line){
+    vector<string> info = read(line);
+    try {
+        if(info.size() < 3) throw invalid_argument(line);
+        ingest.addEdge(stoi(info[0]), stoi(info[1]), stod(info[2]));
+    } catch(const exception&){
+        ingest.addMalformed();
+    }
+}
+
+IngestStats readRealWorldNodes(Graph* graph, string file){
     ifstream fout;
     fout.open(file);
     if(!fout.is_open()) {
         cout << "Error when opening file " << file << endl;
-        return;
+        return {};
     }
-    string tempstream,id, longitude, latitude;
+    GraphIngest ingest(*graph);
+    string tempstream;
     getline(fout, tempstream);
     while (getline (fout, tempstream)) {
         vector<string> info = read(tempstream);
-        id = info[0];
-        longitude = info[1];
-        latitude = info[2];
-        graph->addNode(stoi(id), stod(longitude), stod(latitude));
+        try {
+            if(info.size() < 3) throw invalid_argument(tempstream);
+            ingest.addNode(stoi(info[0]), stod(info[1]), stod(info[2]));
+        } catch(const exception&){
+            ingest.addMalformed();
+        }
     }
     fout.close();
+    return ingest.commit();
 }
 
-void readRealWorldEdges(Graph* graph, string file){
+IngestStats readRealWorldEdges(Graph* graph, string file){
     ifstream fout;
     fout.open(file);
     if(!fout.is_open()) {
         cout << "Error when opening file " << file << endl;
-        return;
+        return {};
     }
-    string tempstream,node1,node2, dist;
+    GraphIngest ingest(*graph);
+    string tempstream;
     getline(fout, tempstream);
-    while (getline (fout, tempstream)) {
-        vector<string> info = read(tempstream);
-        node1 = info[0];
-        node2 = info[1];
-        dist = info[2];
-        graph->addBidirectionalEdge(stoi(node1), stoi(node2), stod(dist));
-    }
+    while (getline (fout, tempstream)) ingestEdgeRow(ingest, tempstream);
+    IngestStats stats = ingest.commit();
     graph->sortEdges();
     fout.close();
+    return stats;
 }
 
 
-void readToyGraph(Graph* graph, string file){
+IngestStats readToyGraph(Graph* graph, string file){
     ifstream fout;
     fout.open(file);
     if(!fout.is_open()) {
         cout << "Error when opening file " << file << endl;
-        return;
+        return {};
     }
-    string tempstream,origem, destino, distancia;
+    GraphIngest ingest(*graph, true);
+    string tempstream;
     getline(fout, tempstream);
-    while (getline (fout, tempstream)) {
-        vector<string> info = read(tempstream);
-        origem = info[0];
-        destino = info[1];
-        distancia = info[2];
-        graph->addNode(stoi(origem));
-        graph->addNode(stoi(destino));
-        graph->addBidirectionalEdge(stoi(origem),stoi(destino), stod(distancia));
-    }
+    while (getline (fout, tempstream)) ingestEdgeRow(ingest, tempstream);
+    IngestStats stats = ingest.commit();
     graph->sortNodes();
     graph->sortEdges();
     fout.close();
+    return stats;
 }
 
-void readExtraFullyConnectedGraph(Graph* graph, string file){
+IngestStats readExtraFullyConnectedGraph(Graph* graph, string file){
     ifstream fout;
     fout.open(file);
     if(!fout.is_open()) {
         cout << "Error when opening file " << file << endl;
-        return;
-    }
-    string tempstream,origem, destino, distancia;
-    while (getline (fout, tempstream)) {
-        vector<string> info = read(tempstream);
-        origem = info[0];
-        destino = info[1];
-        distancia = info[2];
-        graph->addNode(stoi(origem));
-        graph->addNode(stoi(destino));
-        graph->addBidirectionalEdge(stoi(origem),stoi(destino), stod(distancia));
+        return {};
     }
+    GraphIngest ingest(*graph, true);
+    string tempstream;
+    while (getline (fout, tempstream)) ingestEdgeRow(ingest, tempstream);
+    IngestStats stats = ingest.commit();
     graph->sortNodes();
     graph->sortEdges();
     fout.close();
+    return stats;
 }
 
+bool loadDataset(Graph* graph, const string& type, const string& path, Storage storage, IngestStats* stats){
+    if(!graph->setStorage(storage)) return false;
+    IngestStats read;
+    if(type == "real"){
+        if(!ifstream(path + "/nodes.csv").is_open() || !ifstream(path + "/edges.csv").is_open()) return false;
+        read = readRealWorldNodes(graph, path + "/nodes.csv");
+        read += readRealWorldEdges(graph, path + "/edges.csv");
+        graph->setLazyEdges(Graph::LAZY_EDGE_SLOTS);
+    } else {
+        if(!ifstream(path).is_open()) return false;
+        if(type == "toy") read = readToyGraph(graph, path);
+        else if(type == "extra") read = readExtraFullyConnectedGraph(graph, path);
+        else return false;
+    }
+    if(stats != nullptr) *stats = read;
+    return true;
+}
+
+bool loadDataset(Graph* graph, const string& type, const string& path, Storage storage, const ArtifactCache& cache,
+                 uint64_t datasetHash, bool& cached, IngestStats* stats){
+    string params = "type=" + type + ",storage=" + to_string((int) storage) + ",scale=" + to_string(Precision::DEFAULT_SCALE);
+    string payload;
+    cached = cache.load(datasetHash, "graph", params, payload) && graph->setStorage(storage) && graph->deserialize(payload);
+    if(cached){
+        if(type == "real") graph->setLazyEdges(Graph::LAZY_EDGE_SLOTS);
+        return true;
+    }
+    if(!loadDataset(graph, type, path, storage, stats)) return false;
+    payload.clear();
+    graph->serialize(payload);
+    cache.store(datasetHash, "graph", params, payload);     // a read-only cache only costs the next run a parse
+    return true;
+}
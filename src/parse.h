@@ -8,6 +8,8 @@
 #include <fstream>
 #include <sstream>
 #include "calculations.h"
+#include "ArtifactCache.h"
+#include "GraphIngest.h"
 
 using namespace std;
 
@@ -18,6 +20,13 @@ using namespace std;
  * @note Time-complexity -> O(n)
  */
 vector<string> read(std::string filename);
+/**
+ * Escapes the quotes and backslashes of a text, so it can be written inside a JSON string.
+ * @param text Represents the text to escape
+ * @return The escaped text
+ * @note Time-complexity -> O(n) with n being the size of the text
+ */
+std::string escapeJson(const std::string& text);
 /**
  * Checks if a node with a given id is already inside the vector of adjacent edges of another node
  * @param id
@@ -27,32 +36,67 @@ vector<string> read(std::string filename);
  */
 bool isAlreadyInEdges(int id, std::vector<Edge*> edges);
 /**
- * Opens the file given, parses the nodes from the provided file, assuming it's in the Real World graphs' format and closes the file
+ * Opens the file given, parses the nodes from the provided file, assuming it's in the Real World graphs' format and closes the file.
+ * The nodes go through a GraphIngest, so a repeated id keeps its first row.
  * @param graph
  * @param file
+ * @return The stats of the rows, empty if the file could not be opened
  * @note Time-complexity -> O(n)
  */
-void readRealWorldNodes(Graph* graph, std::string filename);
+IngestStats readRealWorldNodes(Graph* graph, std::string filename);
 /**
- * Opens the file given, parses the edges from the provided file, assuming it's in the Real World graphs' format and closes the file
+ * Opens the file given, parses the edges from the provided file, assuming it's in the Real World graphs' format and closes the file.
+ * The edges go through a GraphIngest, which drops self-loops, rows naming unknown nodes and repeated edges.
  * @param graph
  * @param file
- * @note Time-complexity -> O(n)
+ * @return The stats of the rows, empty if the file could not be opened
+ * @note Time-complexity -> O(n*log(n))
  */
-void readRealWorldEdges(Graph* graph, std::string filename);
+IngestStats readRealWorldEdges(Graph* graph, std::string filename);
 /**
- * Opens the file given, parses the nodes and edges from the provided file, assuming it's in the Toy graphs' format, orders the nodes through their id's and closes the file
+ * Opens the file given, parses the nodes and edges from the provided file, assuming it's in the Toy graphs' format, orders the nodes through their id's and closes the file.
+ * The edges go through a GraphIngest, which drops self-loops and repeated edges.
  * @param graph
  * @param file
+ * @return The stats of the rows, empty if the file could not be opened
  * @note Time-complexity -> O( n log(n) )
  */
-void readToyGraph(Graph* graph, std::string filename);
+IngestStats readToyGraph(Graph* graph, std::string filename);
 /**
- * Opens the file given, parses the nodes and edges from the provided file, assuming it's in the Extra Fully Connected graphs' format, orders the nodes through their id's and closes the file
+ * Opens the file given, parses the nodes and edges from the provided file, assuming it's in the Extra Fully Connected graphs' format, orders the nodes through their id's and closes the file.
+ * The edges go through a GraphIngest, which drops self-loops and repeated edges.
  * @param graph
  * @param file
+ * @return The stats of the rows, empty if the file could not be opened
  * @note Time-complexity -> O(n log(n))
  */
-void readExtraFullyConnectedGraph(Graph* graph, std::string filename);
+IngestStats readExtraFullyConnectedGraph(Graph* graph, std::string filename);
+/**
+ * Loads a dataset into the graph with the reader of its type. The real-world graphs are not complete, so they also get a
+ * cache of Graph::LAZY_EDGE_SLOTS missing edges (see Graph::setLazyEdges).
+ * @param graph Represents the graph, which must be empty
+ * @param type Represents the type of the dataset: "toy", "extra" (Extra Fully Connected) or "real"
+ * @param path Represents the dataset file, or for "real" the directory with its nodes.csv and edges.csv
+ * @param storage Represents how the weights and coordinates are stored (see Storage for the precision lost)
+ * @param stats Represents the variable to which the stats of the rows read are written, if not nullptr
+ * @return True if the type is known and the files could be opened, false otherwise.
+ * @note Time-complexity -> The one of the reader used
+ */
+bool loadDataset(Graph* graph, const std::string& type, const std::string& path, Storage storage = Storage::DOUBLE,
+                 IngestStats* stats = nullptr);
+/**
+ * Loads a dataset like loadDataset, but through an ArtifactCache: the parsed graph is kept in the cache, under the hash of
+ * the dataset files and the storage mode, and the next runs read it back with Graph::deserialize instead of parsing the
+ * files again.
+ * @param cache Represents the cache the graph is read from and written to
+ * @param datasetHash Represents the hash of the dataset files, by ArtifactCache::hashDataset
+ * @param cached Represents the variable to which is written if the graph was read from the cache
+ * @param stats Represents the variable to which the stats of the rows read are written if the files were parsed, if not nullptr
+ * @return True if the graph was read from the cache or loadDataset succeeded, false otherwise.
+ * @note Time-complexity -> O(V+E) with V being the number of nodes and E the number of edges if cached, the one of
+ * loadDataset otherwise
+ */
+bool loadDataset(Graph* graph, const std::string& type, const std::string& path, Storage storage, const ArtifactCache& cache,
+                 uint64_t datasetHash, bool& cached, IngestStats* stats = nullptr);
 
 #endif //PROJETO_DA_1_PARSE
@@ -7,10 +7,26 @@
 
 #include "Graph.h"
 #include "NodeEdge.h"
+#include "Stats.h"
 
 using namespace std;
+
+string statsJsonFile, statsTraceFile;   // set by the --stats-json and --stats-trace options
+
+/**
+ * If the stats are enabled, prints the phases and counters collected since the last call, exports them to the files
+ * given in the command line, if any, and clears them for the next run.
+ * @note Time-complexity -> O(T + E) with T being the number of threads and E the number of recorded phases
+ */
+void printStats(){
+    if(!Stats::isEnabled()) return;
+    Stats::print(cout);
+    if(!statsJsonFile.empty() && !Stats::exportJson(statsJsonFile)) cout << "Error when writing file " << statsJsonFile << endl;
+    if(!statsTraceFile.empty() && !Stats::exportChromeTrace(statsTraceFile)) cout << "Error when writing file " << statsTraceFile << endl;
+    Stats::reset();
+}
 /**
- * Iterates through path and prints it. In the end it shows the minimum value.
+ * Iterates through path and prints it. In the end it shows the minimum value, followed by the stats of the run if they are enabled.
  * @param path
  * @param min
  * @note Time-complexity -> O(V) with V being the size of the path vector
@@ -22,6 +38,7 @@ void printPath(std::vector<Node*> path, double min){
         else cout << path[i]->getId() << ", ";
     }
     cout << "Minimum total distance value: " << min << endl;
+    printStats();
 }
 
 #endif //PROJETO_DA_2_PRINT_H
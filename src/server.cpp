@@ -0,0 +1,601 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define TSP_UNIX_SOCKETS
+#endif
+#include "Graph.h"
+#include "parse.h"
+#include "ArtifactCache.h"
+#include "IteratedLocalSearch.h"
+#include "MultiVehicle.h"
+#include "Subgraph.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * One line of input: a solve request, or a command ("stats" or "shutdown").
+ */
+struct Request {
+    string id = "null";     // echoed back as it was written, so it can be any JSON scalar
+    string command;
+    string type;            // toy, extra or real, as in loadDataset
+    string path;
+    string algorithm;       // bt, tah, kmeans, ils or fleet
+    vector<int> stops;      // ids of the nodes to visit, every node if empty
+    unsigned int k = 0;     // kmeans: number of clusters, 0 for sqrt(n)
+    unsigned int seed = 0;  // kmeans, ils and fleet: 0 for the current time
+    double time = -1;       // ils: time budget in seconds (1 if not given); fleet: local search time per route
+    unsigned int workers = 1;       // ils: number of workers
+    unsigned int vehicles = 1;      // fleet: number of vehicles
+    Storage storage = Storage::DOUBLE;
+};
+
+/**
+ * A dataset kept loaded between requests. Solvers that only read the graph (the ones on a subset of stops, the local
+ * searches and the fleet routes) share it; the ones that write to the nodes or edges (kruskal marks, the metric closure,
+ * k-means) take it alone.
+ */
+struct ResidentGraph {
+    once_flag loading;
+    bool loaded = false;
+    Graph graph;
+    unordered_map<int, Node*> byId;
+    shared_mutex solving;
+};
+
+/**
+ * Datasets loaded by the requests so far, each loaded once on first use; other datasets are not held up while one loads.
+ */
+class ResidentGraphs {
+public:
+    explicit ResidentGraphs(const ArtifactCache* cache): cache(cache) {}
+
+    /**
+     * Returns the resident graph of the dataset, loading it if this is the first request for it.
+     * @param fresh Represents the variable to which is written if the dataset was loaded by this call
+     * @return The graph, or nullptr if it could not be loaded
+     * @note Time-complexity -> O(1) on average if resident, the one of loadDataset otherwise
+     */
+    ResidentGraph* get(const Request& request, bool& fresh){
+        string key = request.type + "," + to_string((int) request.storage) + "," + request.path;
+        shared_ptr<ResidentGraph> resident;
+        {
+            lock_guard<mutex> lock(mutex_);
+            shared_ptr<ResidentGraph>& slot = graphs[key];
+            if(slot == nullptr) slot = make_shared<ResidentGraph>();
+            resident = slot;
+        }
+        fresh = false;
+        call_once(resident->loading, [&](){
+            fresh = true;
+            uint64_t hash;
+            bool cached;
+            if(cache != nullptr && ArtifactCache::hashDataset(request.type, request.path, hash)){
+                resident->loaded = loadDataset(&resident->graph, request.type, request.path, request.storage, *cache, hash, cached);
+            } else {
+                resident->loaded = loadDataset(&resident->graph, request.type, request.path, request.storage);
+            }
+            if(!resident->loaded) return;
+            resident->graph.indexEdges();   // built once here, so the shared solvers only read it
+            // the distances missing from a toy graph too, so a request over stops does not depend on the ones before it
+            if(request.type == "toy") MatrixDistance::prepare(resident->graph);
+            for(Node* node : resident->graph.getNodeSet()) resident->byId.emplace(node->getId(), node);
+        });
+        if(resident->loaded) return resident.get();
+        // forgotten, so that a later request tries again, e.g. once the files are there
+        lock_guard<mutex> lock(mutex_);
+        auto it = graphs.find(key);
+        if(it != graphs.end() && it->second == resident) graphs.erase(it);
+        return nullptr;
+    }
+    /**
+     * Returns the number of datasets requested so far.
+     * @note Time-complexity -> O(1)
+     */
+    size_t size(){
+        lock_guard<mutex> lock(mutex_);
+        return graphs.size();
+    }
+
+private:
+    const ArtifactCache* cache;
+    mutex mutex_;
+    map<string, shared_ptr<ResidentGraph>> graphs;   // only the ones that failed to load are erased, so the pointers handed out stay valid
+};
+
+/**
+ * Latencies of the last WINDOW requests, from the moment their line was read to the moment their response was ready.
+ */
+class LatencyTracker {
+public:
+    static const size_t WINDOW = 10000;
+
+    void add(double ms){
+        lock_guard<mutex> lock(mutex_);
+        if(samples.size() < WINDOW) samples.push_back(ms);
+        else samples[next] = ms;
+        next = (next + 1) % WINDOW;
+        total++;
+    }
+    /**
+     * Writes the number of requests served and the p50, p99 and maximum latency of the window, as JSON fields.
+     * @note Time-complexity -> O(W*log(W)) with W being the size of the window
+     */
+    string summary(){
+        vector<double> sorted;
+        unsigned long count;
+        {
+            lock_guard<mutex> lock(mutex_);
+            sorted = samples;
+            count = total;
+        }
+        sort(sorted.begin(), sorted.end());
+        // nearest rank: the smallest sample with at least p of the samples at or below it
+        auto percentile = [&](double p){
+            return sorted.empty() ? 0 : sorted[(size_t) max(0.0, ceil(p * sorted.size()) - 1)];
+        };
+        ostringstream out;
+        out << "\"requests\":" << count << ",\"p50_ms\":" << percentile(0.5) << ",\"p99_ms\":" << percentile(0.99)
+            << ",\"max_ms\":" << (sorted.empty() ? 0 : sorted.back());
+        return out.str();
+    }
+
+private:
+    mutex mutex_;
+    vector<double> samples;
+    size_t next = 0;
+    unsigned long total = 0;
+};
+
+/**
+ * Reads a JSON string starting at the opening quote, leaving i after the closing one.
+ * @return True if the string is well formed, false otherwise
+ * @note Time-complexity -> O(n) with n being the size of the string
+ */
+bool readString(const string& line, size_t& i, string& value){
+    value.clear();
+    for(i++; i < line.size() && line[i] != '"'; i++){
+        if(line[i] == '\\' && ++i == line.size()) return false;
+        value += line[i];
+    }
+    return i++ < line.size();
+}
+
+/**
+ * Reads a JSON number, true, false or null starting at i, leaving i after it.
+ * @note Time-complexity -> O(n) with n being the size of the token
+ */
+string readToken(const string& line, size_t& i){
+    size_t start = i;
+    while(i < line.size() && line[i] != ',' && line[i] != '}' && line[i] != ']' && !isspace((unsigned char) line[i])) i++;
+    return line.substr(start, i - start);
+}
+
+void skipSpaces(const string& line, size_t& i){
+    while(i < line.size() && isspace((unsigned char) line[i])) i++;
+}
+
+/**
+ * Parses a request: one flat JSON object whose values are strings, numbers, booleans or, for "stops", an array of ids.
+ * @param error Represents the variable to which the reason is written if the line is not a valid request
+ * @return True if the line is a valid request, false otherwise
+ * @note Time-complexity -> O(n) with n being the size of the line
+ */
+bool parseRequest(const string& line, Request& request, string& error){
+    size_t i = 0;
+    skipSpaces(line, i);
+    if(i == line.size() || line[i++] != '{'){
+        error = "expected an object";
+        return false;
+    }
+    skipSpaces(line, i);
+    while(i < line.size() && line[i] != '}'){
+        string key, value;
+        if(line[i] != '"' || !readString(line, i, key)){
+            error = "expected a key";
+            return false;
+        }
+        skipSpaces(line, i);
+        if(i == line.size() || line[i++] != ':'){
+            error = "expected ':' after " + key;
+            return false;
+        }
+        skipSpaces(line, i);
+        try {
+            if(key == "stops"){
+                if(i == line.size() || line[i++] != '['){
+                    error = "stops must be an array of ids";
+                    return false;
+                }
+                for(skipSpaces(line, i); i < line.size() && line[i] != ']'; skipSpaces(line, i)){
+                    request.stops.push_back(stoi(readToken(line, i)));
+                    skipSpaces(line, i);
+                    if(i < line.size() && line[i] == ',') i++;
+                }
+                if(i++ == line.size()){
+                    error = "unterminated stops";
+                    return false;
+                }
+            } else {
+                bool quoted = i < line.size() && line[i] == '"';
+                if(quoted && !readString(line, i, value)){
+                    error = "unterminated string";
+                    return false;
+                }
+                if(!quoted) value = readToken(line, i);
+                if(key == "id") request.id = quoted ? "\"" + escapeJson(value) + "\"" : value;
+                else if(key == "command") request.command = value;
+                else if(key == "type") request.type = value;
+                else if(key == "dataset") request.path = value;
+                else if(key == "algorithm") request.algorithm = value;
+                else if(key == "k") request.k = stoul(value);
+                else if(key == "seed") request.seed = stoul(value);
+                else if(key == "time") request.time = stod(value);
+                else if(key == "workers") request.workers = max(1ul, stoul(value));
+                else if(key == "vehicles") request.vehicles = stoul(value);
+                else if(key == "storage"){
+                    if(!Precision::parse(value, request.storage)){
+                        error = "unknown storage " + value;
+                        return false;
+                    }
+                } else {
+                    error = "unknown key " + key;
+                    return false;
+                }
+            }
+        } catch(const exception&){
+            error = "bad value for " + key;
+            return false;
+        }
+        skipSpaces(line, i);
+        if(i < line.size() && line[i] == ',') i++;
+        skipSpaces(line, i);
+    }
+    if(i == line.size()){
+        error = "unterminated object";
+        return false;
+    }
+    if(request.command.empty() && (request.type.empty() || request.path.empty() || request.algorithm.empty())){
+        error = "expected type, dataset and algorithm";
+        return false;
+    }
+    return true;
+}
+
+struct Solution {
+    string status = "ok";
+    double tourLength = 0;
+    vector<Node*> tour;     // closed
+    vector<vector<Node*>> routes;   // fleet: the route of each vehicle, instead of the tour
+};
+
+/**
+ * Solves a request on its resident graph. Over a subset of stops, tah is the Triangular Approximation Heuristic on the
+ * subgraph of the stops and ils improves it; over the whole dataset the algorithms run as in the batch runner.
+ * @note Time-complexity -> The one of the algorithm used
+ */
+Solution solve(const Request& request, ResidentGraph& resident){
+    Graph& graph = resident.graph;
+    Solution solution;
+    vector<Node*>& tour = solution.tour;
+    double& tourLength = solution.tourLength;
+    unsigned int seed = request.seed != 0 ? request.seed : time(nullptr);
+    if(!request.stops.empty()){
+        vector<Node*> stops;
+        unordered_set<int> seen;
+        for(int id : request.stops){
+            auto it = resident.byId.find(id);
+            if(it == resident.byId.end() || !seen.insert(id).second){
+                solution.status = "invalid_stops";
+                return solution;
+            }
+            stops.push_back(it->second);
+        }
+        if(request.algorithm != "tah" && request.algorithm != "ils"){
+            solution.status = "unsupported_with_stops";
+            return solution;
+        }
+        shared_lock<shared_mutex> lock(resident.solving);
+        Subgraph subgraph(graph, stops);
+        subgraph.kruskal();
+        tourLength = subgraph.preOrder(tour);
+        tour.push_back(tour.front());
+        if(request.algorithm == "ils" && stops.size() > 3){
+            IteratedLocalSearch search(graph, tour);
+            tourLength = search.run(request.workers, request.time >= 0 ? request.time : 1, seed);
+            tour = search.getTour();
+            tour.pop_back();
+            rotate(tour.begin(), find(tour.begin(), tour.end(), stops[0]), tour.end());
+            tour.push_back(stops[0]);
+        }
+        return solution;
+    }
+
+    if(request.algorithm == "ils" || request.algorithm == "fleet"){
+        vector<Node*> start;
+        if(request.algorithm == "ils"){
+            unique_lock<shared_mutex> lock(resident.solving);
+            graph.TriangularApproximationHeuristic(graph.getNodeSet(), start, request.type);
+        }
+        shared_lock<shared_mutex> lock(resident.solving);
+        if(request.algorithm == "fleet"){
+            MultiVehicle fleet(graph, request.type, request.vehicles);
+            tourLength = fleet.run(max(0.0, request.time), seed);
+            solution.routes = fleet.getRoutes();
+            return solution;
+        }
+        IteratedLocalSearch search(graph, start);
+        tourLength = search.run(request.workers, request.time >= 0 ? request.time : 1, seed);
+        tour = search.getTour();
+        return solution;
+    }
+    unique_lock<shared_mutex> lock(resident.solving);
+    if(request.algorithm == "bt"){
+        tourLength = graph.tspBT(tour);
+    } else if(request.algorithm == "tah"){
+        tourLength = graph.TriangularApproximationHeuristic(graph.getNodeSet(), tour, request.type);
+    } else if(request.algorithm == "kmeans"){
+        vector<Node*> emptyCluster;
+        int k = request.k != 0 ? request.k : sqrt(graph.getNumNode());
+        tour = graph.kMeansDivideAndConquer(k, emptyCluster, tourLength, true, seed);
+    } else {
+        solution.status = "unknown_algorithm";
+    }
+    if(find(tour.begin(), tour.end(), nullptr) != tour.end()){
+        // tspBT leaves the path empty when the graph has no tour it can close
+        solution.status = "no_tour";
+        tourLength = 0;
+        tour.clear();
+    }
+    return solution;
+}
+
+/**
+ * Serves the requests read from a stream, each on the request pool, and writes every response (one JSON line, in the
+ * order they finish) to a sink.
+ */
+class Server {
+public:
+    Server(ResidentGraphs& graphs, LatencyTracker& latencies, ThreadPool& pool): graphs(graphs), latencies(latencies), pool(pool) {}
+
+    /**
+     * Handles one line of input: commands are answered at once, solve requests are queued on the pool.
+     * @param write Represents the sink of the response, called from any thread
+     * @return False if the line was a shutdown command, true otherwise
+     * @note Time-complexity -> O(n) with n being the size of the line, plus the solve on the pool
+     */
+    bool handle(const string& line, const function<void(const string&)>& write){
+        auto received = chrono::steady_clock::now();
+        Request request;
+        string error;
+        if(!parseRequest(line, request, error)){
+            write("{\"id\":" + request.id + ",\"status\":\"bad_request\",\"error\":\"" + escapeJson(error) + "\"}");
+            return true;
+        }
+        if(request.command == "shutdown"){
+            write("{\"id\":" + request.id + ",\"status\":\"ok\"}");
+            return false;
+        }
+        if(request.command == "stats"){
+            write("{\"id\":" + request.id + ",\"status\":\"ok\",\"graphs\":" + to_string(graphs.size()) + "," + latencies.summary() + "}");
+            return true;
+        }
+        if(!request.command.empty()){
+            write("{\"id\":" + request.id + ",\"status\":\"bad_request\",\"error\":\"unknown command\"}");
+            return true;
+        }
+        pool.submit([this, request, write, received](){
+            write(run(request, received));
+        });
+        return true;
+    }
+
+private:
+    /**
+     * Solves a request and returns its response.
+     * @note Time-complexity -> The one of the algorithm used, plus loading the dataset on its first request
+     */
+    string run(const Request& request, chrono::steady_clock::time_point received){
+        auto start = chrono::steady_clock::now();
+        bool fresh;
+        ResidentGraph* resident = graphs.get(request, fresh);
+        auto loaded = chrono::steady_clock::now();
+        Solution solution;
+        if(resident == nullptr) solution.status = "load_error";
+        else solution = solve(request, *resident);
+        auto end = chrono::steady_clock::now();
+        double latency = chrono::duration<double, milli>(end - received).count();
+        latencies.add(latency);
+
+        ostringstream out;
+        out.precision(15);
+        out << "{\"id\":" << request.id << ",\"status\":\"" << solution.status << "\",\"tour_length\":" << solution.tourLength << ",\"tour\":[";
+        for(int i = 0; i < solution.tour.size(); i++) out << (i ? "," : "") << solution.tour[i]->getId();
+        out << "]";
+        if(!solution.routes.empty()){
+            out << ",\"routes\":[";
+            for(int r = 0; r < solution.routes.size(); r++){
+                out << (r ? ",[" : "[");
+                for(int i = 0; i < solution.routes[r].size(); i++) out << (i ? "," : "") << solution.routes[r][i]->getId();
+                out << "]";
+            }
+            out << "]";
+        }
+        out << ",\"loaded\":" << (fresh ? "true" : "false")
+            << ",\"queue_ms\":" << chrono::duration<double, milli>(start - received).count()
+            << ",\"load_ms\":" << chrono::duration<double, milli>(loaded - start).count()
+            << ",\"solve_ms\":" << chrono::duration<double, milli>(end - loaded).count()
+            << ",\"latency_ms\":" << latency << "}";
+        return out.str();
+    }
+
+    ResidentGraphs& graphs;
+    LatencyTracker& latencies;
+    ThreadPool& pool;
+};
+
+#ifdef TSP_UNIX_SOCKETS
+/**
+ * Serves the clients of a Unix domain socket, each connection on a thread of its own that reads its request lines; the
+ * responses of a connection are written back to it as they finish. The threads of the connections that closed are
+ * joined as new ones are accepted. Returns when a client sends a shutdown command.
+ * @return True if the socket could be set up, false otherwise
+ */
+bool serveSocket(const string& path, Server& server){
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(listener < 0 || path.size() >= sizeof(address.sun_path)) return false;
+    strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+    if(bind(listener, (sockaddr*) &address, sizeof(address)) != 0 || listen(listener, 64) != 0){
+        close(listener);
+        return false;
+    }
+    struct Connection {
+        thread reader;
+        atomic<bool> done{false};
+    };
+    atomic<bool> stopping{false};
+    list<Connection> connections;
+    unordered_set<int> clients;     // the connections still being read, whose descriptors are still open
+    mutex clientsMutex;
+    while(!stopping){
+        int client = accept(listener, nullptr, nullptr);
+        for(auto it = connections.begin(); it != connections.end();){
+            if(!it->done){
+                it++;
+                continue;
+            }
+            it->reader.join();
+            it = connections.erase(it);
+        }
+        if(client < 0) continue;
+        {
+            lock_guard<mutex> lock(clientsMutex);
+            clients.insert(client);
+        }
+        Connection& connection = connections.emplace_back();
+        connection.reader = thread([client, &server, &stopping, listener, &clients, &clientsMutex, &connection](){
+            // closed by whichever holder of the writer goes last: this reader or the last queued response
+            auto writeMutex = make_shared<mutex>();
+            shared_ptr<int> fd(new int(client), [](int* fd){ close(*fd); delete fd; });
+            auto write = [fd, writeMutex](const string& response){
+                lock_guard<mutex> lock(*writeMutex);
+                string line = response + "\n";
+                for(size_t sent = 0; sent < line.size();){
+                    ssize_t n = send(*fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+                    if(n <= 0) return;
+                    sent += n;
+                }
+            };
+            string buffer;
+            char chunk[4096];
+            ssize_t n;
+            bool reading = true;
+            while(reading && (n = recv(client, chunk, sizeof(chunk), 0)) > 0){
+                buffer.append(chunk, n);
+                size_t end;
+                while(reading && (end = buffer.find('\n')) != string::npos){
+                    string line = buffer.substr(0, end);
+                    buffer.erase(0, end + 1);
+                    if(!line.empty() && line.back() == '\r') line.pop_back();
+                    if(line.empty()) continue;
+                    if(!server.handle(line, write)){
+                        stopping = true;
+                        shutdown(listener, SHUT_RDWR);    // wakes up the accept of the main thread
+                        reading = false;
+                    }
+                }
+            }
+            {
+                // forgotten while fd still holds the descriptor, so its number cannot have been reused yet
+                lock_guard<mutex> lock(clientsMutex);
+                clients.erase(client);
+            }
+            connection.done = true;
+        });
+    }
+    {
+        // the other clients stop being read, so their threads end; the responses already queued are still sent
+        lock_guard<mutex> lock(clientsMutex);
+        for(int client : clients) shutdown(client, SHUT_RD);
+    }
+    for(Connection& connection : connections) connection.reader.join();
+    close(listener);
+    unlink(path.c_str());
+    return true;
+}
+#endif
+
+int main(int argc, char** argv){
+    string socketPath, cacheDirectory;
+    unsigned int nThreads = thread::hardware_concurrency();
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "-j" && i + 1 < argc) nThreads = max(1ul, stoul(argv[++i]));
+        else if(arg == "--socket" && i + 1 < argc) socketPath = argv[++i];
+        else if(arg == "--cache" && i + 1 < argc) cacheDirectory = argv[++i];
+        else {
+            cerr << "Usage: " << argv[0] << " [--socket path] [-j concurrent requests] [--cache directory]\n"
+                    "Reads one JSON request per line from stdin (or from each client of the Unix socket) and writes one JSON\n"
+                    "response per line as each finishes. A request is {\"id\":..,\"type\":\"toy|extra|real\",\"dataset\":path,\n"
+                    "\"algorithm\":\"bt|tah|kmeans|ils|fleet\"[,\"stops\":[ids]][,\"time\":s][,\"seed\":..][,\"k\":..][,\"workers\":..]\n"
+                    "[,\"vehicles\":..][,\"storage\":..]}; {\"command\":\"stats\"} answers the p50/p99 latencies and\n"
+                    "{\"command\":\"shutdown\"} stops the server. Datasets stay loaded after their first request.\n";
+            return 2;
+        }
+    }
+
+    unique_ptr<ArtifactCache> cache;
+    if(!cacheDirectory.empty()) cache = make_unique<ArtifactCache>(cacheDirectory);
+    ResidentGraphs graphs(cache.get());
+    LatencyTracker latencies;
+    mutex outMutex;
+    auto write = [&outMutex](const string& response){
+        lock_guard<mutex> lock(outMutex);
+        cout << response << endl;
+    };
+    {
+        // the pool is destroyed at the end of the scope, once every queued request has been answered
+        ThreadPool pool(nThreads);
+        Server server(graphs, latencies, pool);
+        if(!socketPath.empty()){
+#ifdef TSP_UNIX_SOCKETS
+            if(!serveSocket(socketPath, server)){
+                cerr << "Error when listening on " << socketPath << endl;
+                return 1;
+            }
+#else
+            cerr << "Unix sockets are not supported on this platform" << endl;
+            return 1;
+#endif
+        } else {
+            string line;
+            while(getline(cin, line)){
+                if(!line.empty() && line.back() == '\r') line.pop_back();
+                if(!line.empty() && !server.handle(line, write)) break;
+            }
+        }
+    }
+    cerr << "{" << latencies.summary() << "}" << endl;
+    return 0;
+}